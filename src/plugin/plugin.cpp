@@ -1,5 +1,7 @@
 #include "../qmlplotting/colormappedimage.h"
 #include "../qmlplotting/datasource.h"
+#include "../qmlplotting/mappeddatasource.h"
+#include "../qmlplotting/multitraceplot.h"
 #include "../qmlplotting/sliceplot.h"
 #include "../qmlplotting/xyplot.h"
 #include "../qmlplotting/plotgroup.h"
@@ -23,6 +25,8 @@ public:
 
         qmlRegisterType<ColormappedImage>(uri, 2, 0, "ColormappedImage");
         qmlRegisterType<DataSource>(uri, 2, 0, "DataSource");
+        qmlRegisterType<MappedDataSource>(uri, 2, 0, "MappedDataSource");
+        qmlRegisterType<MultiTracePlot>(uri, 2, 0, "MultiTracePlot");
         qmlRegisterType<SlicePlot>(uri, 2, 0, "SlicePlot");
         qmlRegisterType<XYPlot>(uri, 2, 0, "XYPlot");
         qmlRegisterType<PlotGroup>(uri, 2, 0, "PlotGroup");
@@ -7,8 +7,13 @@
 #include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
 #include "qsgdatatexture.h"
 #include "colormaps.h"
+#include "convertkernels.h"
 
 #define GLSL(ver, src) "#version " #ver "\n" #src
 
@@ -17,18 +22,34 @@
 class QSQColormapMaterial : public QSGMaterial
 {
 public:
-    QSGMaterialType *type() const override { static QSGMaterialType type; return &type; }
+    explicit QSQColormapMaterial(bool volume = false) : m_volume(volume) {}
+    QSGMaterialType *type() const override {
+        // volumes are sampled by a different shader
+        static QSGMaterialType type_image;
+        static QSGMaterialType type_volume;
+        return m_volume ? &type_volume : &type_image;
+    }
     QSGMaterialShader *createShader() const override;
+    const bool m_volume;
     QSGTexture* m_texture_image;
-    QSGDataTexture<float> m_texture_cmap;
+    QSGDataTexture<float>* m_texture_cmap;
     double m_amplitude;
     double m_offset;
+    // ring buffer data is sampled with repeat on the row axis, shifted by the row offset
+    // and clamped to the centers of the outer rows (in texture coordinates)
+    double m_row_offset;
+    double m_row_clamp = 0.;
     QSGTexture::Filtering m_filter;
+    // slice plane of volume data, position in texture coordinates along the axis (0 = depth, 1 = height, 2 = width)
+    double m_slice = 0.;
+    int m_slice_axis = 0;
 };
 
 class QSQColormapShader : public QSGMaterialShader
 {
 public:
+    explicit QSQColormapShader(bool volume) : m_volume(volume) {}
+
     const char *vertexShader() const override {
         return GLSL(130,
             in highp vec4 vertex;
@@ -44,18 +65,45 @@ public:
     }
 
     const char *fragmentShader() const override {
+        if (m_volume) {
+            return GLSL(130,
+                uniform sampler2D cmap;
+                uniform sampler3D image;
+                uniform highp float amplitude;
+                uniform highp float offset;
+                uniform highp float slice;
+                uniform int sliceaxis;
+                uniform lowp float opacity;
+                in highp vec2 coord;
+                out vec4 fragColor;
+
+                void main() {
+                    bool inside = coord.s > 0. && coord.s < 1. && coord.t > 0. && coord.t < 1.;
+                    highp vec3 p = (sliceaxis == 0) ? vec3(coord, slice) : ((sliceaxis == 1) ? vec3(coord.s, slice, coord.t) : vec3(slice, coord));
+                    highp float val = texture(image, p).r;
+                    val = amplitude * (val + offset);
+                    vec4 color = texture(cmap, vec2(val, 0.));
+                    lowp float o = opacity * color.a * float(inside);
+                    fragColor.rgb = color.rgb * o;
+                    fragColor.a = o;
+                }
+            );
+        }
         return GLSL(130,
             uniform sampler2D cmap;
             uniform sampler2D image;
             uniform highp float amplitude;
             uniform highp float offset;
+            uniform highp float rowoffset;
+            uniform highp float rowclamp;
             uniform lowp float opacity;
             in highp vec2 coord;
             out vec4 fragColor;
 
             void main() {
                 bool inside = coord.s > 0. && coord.s < 1. && coord.t > 0. && coord.t < 1.;
-                highp float val = texture(image, coord.st).r;
+                highp float t = clamp(coord.t, rowclamp, 1. - rowclamp) + rowoffset;
+                highp float val = texture(image, vec2(coord.s, t)).r;
                 val = amplitude * (val + offset);
                 vec4 color = texture(cmap, vec2(val, 0.));
                 lowp float o = opacity * color.a * float(inside);
@@ -80,6 +128,10 @@ public:
         m_id_cmap = program()->uniformLocation("cmap");
         m_id_amplitude = program()->uniformLocation("amplitude");
         m_id_offset = program()->uniformLocation("offset");
+        m_id_row_offset = program()->uniformLocation("rowoffset");
+        m_id_row_clamp = program()->uniformLocation("rowclamp");
+        m_id_slice = program()->uniformLocation("slice");
+        m_id_slice_axis = program()->uniformLocation("sliceaxis");
     }
 
     void activate() override {
@@ -101,14 +153,21 @@ public:
         // Bind material parameters
         program()->setUniformValue(m_id_amplitude, float(material->m_amplitude));
         program()->setUniformValue(m_id_offset, float(material->m_offset));
+        program()->setUniformValue(m_id_row_offset, float(material->m_row_offset));
+        program()->setUniformValue(m_id_row_clamp, float(material->m_row_clamp));
+        if (m_volume) {
+            program()->setUniformValue(m_id_slice, float(material->m_slice));
+            program()->setUniformValue(m_id_slice_axis, material->m_slice_axis);
+        }
 
         // Bind the material textures (image and colormap)
         functions->glActiveTexture(GL_TEXTURE1);
         program()->setUniformValue(m_id_cmap, 1);
-        material->m_texture_cmap.bind();
+        material->m_texture_cmap->bind();
         functions->glActiveTexture(GL_TEXTURE0);
         program()->setUniformValue(m_id_image, 0);
         material->m_texture_image->setFiltering(material->m_filter);
+        material->m_texture_image->setVerticalWrapMode((material->m_row_clamp > 0.) ? QSGTexture::Repeat : QSGTexture::ClampToEdge);
         material->m_texture_image->bind();
     }
 
@@ -118,20 +177,76 @@ public:
         functions->glActiveTexture(GL_TEXTURE1);
         functions->glBindTexture(GL_TEXTURE_1D, 0);
         functions->glActiveTexture(GL_TEXTURE0);
-        functions->glBindTexture(GL_TEXTURE_2D, 0);
+        functions->glBindTexture(m_volume ? GL_TEXTURE_3D : GL_TEXTURE_2D, 0);
     }
 
 private:
+    const bool m_volume;
     int m_id_matrix;
     int m_id_opacity;
     int m_id_image;
     int m_id_cmap;
     int m_id_amplitude;
     int m_id_offset;
+    int m_id_row_offset;
+    int m_id_row_clamp;
+    int m_id_slice;
+    int m_id_slice_axis;
 };
 
 
-inline QSGMaterialShader* QSQColormapMaterial::createShader() const { return new QSQColormapShader; }
+inline QSGMaterialShader* QSQColormapMaterial::createShader() const { return new QSQColormapShader(m_volume); }
+
+
+// Texture and node of one image tile, the node is only in the scene graph while the tile is visible
+struct ImageTile
+{
+    ImageTile() = default;
+    ImageTile(const ImageTile&) = delete;
+    ImageTile& operator=(const ImageTile&) = delete;
+    ~ImageTile() = default;
+    QSGDataTexture<float> m_texture;
+    std::unique_ptr<QSGGeometryNode> m_node;
+    // data pixels covered by the texture, including the border shared with neighbouring tiles
+    QRect m_texture_rect;
+    quint64 m_last_used = 0;
+    bool m_valid = false;
+};
+
+// Root node, owns the colormap texture and the tile cache
+class ColormappedImageNode : public QSGNode
+{
+public:
+    ColormappedImageNode() = default;
+    ~ColormappedImageNode() override = default;
+
+    // Remove the single image node and all tiles
+    void clear() {
+        m_tiles.clear();
+        while (firstChild() != nullptr) {
+            QSGNode* child = firstChild();
+            removeChildNode(child);
+            delete child;
+        }
+    }
+
+    qint64 tileBytes() const {
+        qint64 bytes = 0;
+        for (const auto& tile : m_tiles) {
+            bytes += qint64(sizeof(float)) * tile.second.m_texture_rect.width() * tile.second.m_texture_rect.height();
+        }
+        return bytes;
+    }
+
+    QSGDataTexture<float> m_texture_cmap;
+    std::map<std::pair<int, int>, ImageTile> m_tiles;
+    bool m_tiled = false;
+    int m_tile_size = 0;
+    QSize m_data_size;
+    quint64 m_frame = 0;
+    // change count of the source the tiles are up to date with
+    qint64 m_change_count = 0;
+};
 
 // ----------------------------------------------------------------------------
 
@@ -211,64 +326,311 @@ QString ColormappedImage::getFilter() const
     return (m_filter == QSGTexture::Linear) ? QStringLiteral("linear") : QStringLiteral("nearest");
 }
 
-static void updateColormapTexture(QSGDataTexture<float>& texture, const QString& colormap) {
-    texture.setFiltering(QSGTexture::Linear);
-
-    // Get colormap data pointer and number of samples by name
-    double* data;
-    int numpoints;
-    if (colormap == QStringLiteral("wjet")) {
-        data = const_cast<double*>(cmap_wjet);
-        numpoints = sizeof(cmap_wjet) / (3*sizeof(double));
-    } else if (colormap == QStringLiteral("jet")) {
-        data = const_cast<double*>(cmap_jet);
-        numpoints = sizeof(cmap_jet) / (3*sizeof(double));
-    } else if (colormap == QStringLiteral("hot")) {
-        data = const_cast<double*>(cmap_hot);
-        numpoints = sizeof(cmap_hot) / (3*sizeof(double));
-    } else if (colormap == QStringLiteral("bwr")) {
-        data = const_cast<double*>(cmap_bwr);
-        numpoints = sizeof(cmap_bwr) / (3*sizeof(double));
-    } else if (colormap == QStringLiteral("viridis")) {
-        data = const_cast<double*>(cmap_viridis);
-        numpoints = sizeof(cmap_viridis) / (3*sizeof(double));
-    } else if (colormap == QStringLiteral("ferrugineus")) {
-        data = const_cast<double*>(cmap_ferrugineus);
-        numpoints = sizeof(cmap_ferrugineus) / (3*sizeof(double));
-    } else {
-        data = const_cast<double*>(cmap_gray);
-        numpoints = sizeof(cmap_gray) / (3*sizeof(double));
-    }
-
-    // Copy colormap to data texture
-    float* textureBuffer = texture.allocateData2D(numpoints, 1, 3);
-    for (int i = 0; i < numpoints*3; ++i) {
-        textureBuffer[i] = static_cast<float>(data[i]);
-    }
-    texture.commitData();
+void ColormappedImage::setAutoRange(bool enabled)
+{
+    if (enabled != m_auto_range) {
+        m_auto_range = enabled;
+        emit autoRangeChanged(enabled);
+        updateAutoRange();
+    }
+}
+
+void ColormappedImage::setAutoRangePercentile(double percent)
+{
+    percent = qBound(0., percent, 50.);
+    if (percent != m_auto_range_percentile) {
+        m_auto_range_percentile = percent;
+        emit autoRangePercentileChanged(percent);
+        updateAutoRange();
+    }
 }
 
-QSGNode* ColormappedImage::updatePaintNode(QSGNode* n, QQuickItem::UpdatePaintNodeData*)
+void ColormappedImage::setSlice(double slice)
 {
+    if (slice != m_slice) {
+        m_slice = slice;
+        emit sliceChanged(m_slice);
+        update();
+    }
+}
+
+void ColormappedImage::setSliceAxis(int axis)
+{
+    axis = qBound(0, axis, 2);
+    if (axis != m_slice_axis) {
+        m_slice_axis = axis;
+        emit sliceAxisChanged(m_slice_axis);
+        emit numSlicesChanged();
+        update();
+    }
+}
+
+int ColormappedImage::numSlices() const
+{
+    if (m_source == nullptr || m_source->dataDimensions() != 3) {
+        return 0;
+    }
+    switch (m_slice_axis) {
+    case 1:
+        return m_source->dataHeight();
+    case 2:
+        return m_source->dataWidth();
+    default:
+        return m_source->dataDepth();
+    }
+}
+
+void ColormappedImage::setDataSource(QQuickItem* item)
+{
+    if (m_source != nullptr) {
+        disconnect(m_source, &DataSource::statisticsChanged, this, &ColormappedImage::updateAutoRange);
+        disconnect(m_source, &DataSource::dataSizeChanged, this, &ColormappedImage::numSlicesChanged);
+    }
+    DataClient::setDataSource(item);
+    if (m_source != nullptr) {
+        connect(m_source, &DataSource::statisticsChanged, this, &ColormappedImage::updateAutoRange);
+        connect(m_source, &DataSource::dataSizeChanged, this, &ColormappedImage::numSlicesChanged);
+    }
+    updateAutoRange();
+    emit numSlicesChanged();
+}
+
+void ColormappedImage::updateAutoRange()
+{
+    if (!m_auto_range || m_source == nullptr || m_source->statistics().isEmpty()) {
+        return;
+    }
+    const double lower = m_source->percentile(m_auto_range_percentile);
+    const double upper = m_source->percentile(100. - m_auto_range_percentile);
+    // constant data keeps the previous range
+    if (upper > lower) {
+        setMinimumValue(lower);
+        setMaximumValue(upper);
+    }
+}
+
+void ColormappedImage::setTileSize(int size)
+{
+    size = std::max(size, 0);
+    if (size != m_tile_size) {
+        m_tile_size = size;
+        emit tileSizeChanged(size);
+        update();
+    }
+}
+
+void ColormappedImage::setTileMemoryBudget(int mib)
+{
+    if (mib != m_tile_budget) {
+        m_tile_budget = mib;
+        emit tileMemoryBudgetChanged(mib);
+        update();
+    }
+}
+
+// Convert one row of tile data to float
+template<typename T>
+static void copyTileRow(const T* src, int n, float* dst)
+{
+    for (int i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+}
+
+static void copyTileRow(const double* src, int n, float* dst)
+{
+    convertToFloat(src, n, dst);
+}
+
+template<typename T>
+static void copyTile(const T* src, int row_length, const QRect& rect, float* dst)
+{
+    for (int y = 0; y < rect.height(); ++y) {
+        copyTileRow(src + qint64(rect.y() + y) * row_length + rect.x(), rect.width(), dst + qint64(y) * rect.width());
+    }
+}
+
+void ColormappedImage::updateTiles(ColormappedImageNode* n)
+{
+    QMLPLOTTING_TRACE_SCOPE("ColormappedImage::updateTiles");
+    const int data_width = m_source->dataWidth();
+    const int data_height = m_source->dataHeight();
+    const int tile_size = m_tile_size;
+
+    // Tiles hold values in data units, only the colormap range has to be mapped
+    const double cmap_margin = .5 / n->m_texture_cmap.getDim(0);
+    const double amplitude = (1. - 2.*cmap_margin) / (m_max_value - m_min_value);
+    const double offset = (cmap_margin / amplitude) - m_min_value;
+
+    // Visible range in data pixels (extent may be flipped)
+    const double pixel_width = (m_extent[1] - m_extent[0]) / data_width;
+    const double pixel_height = (m_extent[3] - m_extent[2]) / data_height;
+    const double vx1 = (m_view_rect.left() - m_extent[0]) / pixel_width;
+    const double vx2 = (m_view_rect.right() - m_extent[0]) / pixel_width;
+    const double vy1 = (m_view_rect.top() - m_extent[2]) / pixel_height;
+    const double vy2 = (m_view_rect.bottom() - m_extent[2]) / pixel_height;
+    const double px_min = std::max(std::min(vx1, vx2), 0.);
+    const double px_max = std::min(std::max(vx1, vx2), double(data_width));
+    const double py_min = std::max(std::min(vy1, vy2), 0.);
+    const double py_max = std::min(std::max(vy1, vy2), double(data_height));
+
+    // Map data pixels to item coordinates
+    const auto itemX = [&](double px) {
+        return static_cast<float>((m_extent[0] + px * pixel_width - m_view_rect.left()) / m_view_rect.width() * width());
+    };
+    const auto itemY = [&](double py) {
+        return static_cast<float>(height() - (m_extent[2] + py * pixel_height - m_view_rect.top()) / m_view_rect.height() * height());
+    };
+
+    ++n->m_frame;
+    if (px_min < px_max && py_min < py_max) {
+        const int tx_first = static_cast<int>(px_min) / tile_size;
+        const int tx_last = (static_cast<int>(std::ceil(px_max)) - 1) / tile_size;
+        const int ty_first = static_cast<int>(py_min) / tile_size;
+        const int ty_last = (static_cast<int>(std::ceil(py_max)) - 1) / tile_size;
+        for (int ty = ty_first; ty <= ty_last; ++ty) {
+            for (int tx = tx_first; tx <= tx_last; ++tx) {
+                ImageTile& tile = n->m_tiles[{tx, ty}];
+                const QRect rect(tx * tile_size, ty * tile_size,
+                                 std::min(tile_size, data_width - tx * tile_size),
+                                 std::min(tile_size, data_height - ty * tile_size));
+                if (!tile.m_node) {
+                    // Textures overlap by one pixel so linear filtering is continuous across tiles
+                    tile.m_texture_rect = rect.adjusted(rect.left() > 0 ? -1 : 0, rect.top() > 0 ? -1 : 0,
+                                                        rect.right() < data_width - 1 ? 1 : 0,
+                                                        rect.bottom() < data_height - 1 ? 1 : 0);
+                    tile.m_node.reset(new QSGGeometryNode);
+                    auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4);
+                    geometry->setDrawingMode(GL_TRIANGLE_STRIP);
+                    tile.m_node->setGeometry(geometry);
+                    tile.m_node->setFlag(QSGNode::OwnsGeometry);
+                    auto* material = new QSQColormapMaterial;
+                    material->m_texture_image = &tile.m_texture;
+                    material->m_texture_cmap = &n->m_texture_cmap;
+                    material->m_row_offset = 0.;
+                    tile.m_node->setMaterial(material);
+                    tile.m_node->setFlag(QSGNode::OwnsMaterial);
+                }
+                if (!tile.m_valid) {
+                    const QRect& texture_rect = tile.m_texture_rect;
+                    float* dst = tile.m_texture.allocateData2D(texture_rect.width(), texture_rect.height(), 1);
+                    m_source->visitData([&](const auto* src) {
+                        copyTile(src, data_width, texture_rect, dst);
+                    });
+                    tile.m_texture.commitData();
+                    tile.m_valid = true;
+                }
+                tile.m_last_used = n->m_frame;
+
+                // Quad of the visible part of the tile
+                const double x1 = std::max(px_min, double(rect.left()));
+                const double x2 = std::min(px_max, double(rect.left() + rect.width()));
+                const double y1 = std::max(py_min, double(rect.top()));
+                const double y2 = std::min(py_max, double(rect.top() + rect.height()));
+                const QRect& texture_rect = tile.m_texture_rect;
+                const auto u = [&](double px) { return static_cast<float>((px - texture_rect.left()) / texture_rect.width()); };
+                const auto v = [&](double py) { return static_cast<float>((py - texture_rect.top()) / texture_rect.height()); };
+                QSGGeometry* geometry = tile.m_node->geometry();
+                geometry->vertexDataAsTexturedPoint2D()[0] = {itemX(x1), itemY(y2), u(x1), v(y2)};
+                geometry->vertexDataAsTexturedPoint2D()[1] = {itemX(x1), itemY(y1), u(x1), v(y1)};
+                geometry->vertexDataAsTexturedPoint2D()[2] = {itemX(x2), itemY(y2), u(x2), v(y2)};
+                geometry->vertexDataAsTexturedPoint2D()[3] = {itemX(x2), itemY(y1), u(x2), v(y1)};
+
+                auto* material = static_cast<QSQColormapMaterial*>(tile.m_node->material());
+                material->m_amplitude = amplitude;
+                material->m_offset = offset;
+                material->m_filter = m_filter;
+
+                if (tile.m_node->parent() == nullptr) {
+                    n->appendChildNode(tile.m_node.get());
+                }
+                tile.m_node->markDirty(QSGNode::DirtyGeometry | QSGNode::DirtyMaterial);
+            }
+        }
+    }
+
+    // Detach tiles which left the view, they stay cached
+    for (auto& tile : n->m_tiles) {
+        if (tile.second.m_last_used != n->m_frame && tile.second.m_node->parent() != nullptr) {
+            n->removeChildNode(tile.second.m_node.get());
+        }
+    }
+
+    // Evict least recently used tiles until the cache fits into the budget, visible tiles are kept
+    const qint64 budget = qint64(m_tile_budget) * 1024 * 1024;
+    qint64 bytes = n->tileBytes();
+    while (bytes > budget) {
+        auto oldest = n->m_tiles.end();
+        for (auto it = n->m_tiles.begin(); it != n->m_tiles.end(); ++it) {
+            if (it->second.m_last_used != n->m_frame &&
+                    (oldest == n->m_tiles.end() || it->second.m_last_used < oldest->second.m_last_used)) {
+                oldest = it;
+            }
+        }
+        if (oldest == n->m_tiles.end()) {
+            break;
+        }
+        bytes -= qint64(sizeof(float)) * oldest->second.m_texture_rect.width() * oldest->second.m_texture_rect.height();
+        n->m_tiles.erase(oldest);
+    }
+}
+
+QSGNode* ColormappedImage::updatePaintNode(QSGNode* node, QQuickItem::UpdatePaintNodeData*)
+{
+    PaintScope paint_scope(m_render_stats, this);
     QSGGeometryNode* n_geom;
     QSGGeometry* geometry;
     QSQColormapMaterial* material;
 
-    if (n == nullptr) {
-        n = new QSGNode;
+    if (node == nullptr) {
+        node = new ColormappedImageNode;
+        // Force colormap initialization
+        m_new_colormap = true;
     }
+    auto* n = static_cast<ColormappedImageNode*>(node);
 
     if (m_source == nullptr) {
-        // Remove child node if there is no data source
-        if (n->firstChild() != nullptr) {
-            n_geom = static_cast<QSGGeometryNode*>(n->firstChild());
-            n->removeAllChildNodes();
-            delete n_geom;
-        }
+        // Remove child nodes if there is no data source
+        n->clear();
         // Return empty node
         return n;
     }
 
+    // Check if the colormap should be updated
+    if (m_new_colormap) {
+        updateColormapTexture(n->m_texture_cmap, m_colormap);
+        m_new_colormap = false;
+    }
+
+    // Large 2D images are split into tiles, ring buffers are always shown as a single texture
+    const bool tiled = m_tile_size > 0 && m_source->dataDimensions() == 2 && !m_source->streaming();
+    const QSize data_size(m_source->dataWidth(), m_source->dataHeight());
+    if (tiled != n->m_tiled || (tiled && (n->m_tile_size != m_tile_size || n->m_data_size != data_size))) {
+        n->clear();
+        n->m_tiled = tiled;
+        n->m_tile_size = m_tile_size;
+        n->m_data_size = data_size;
+    }
+    if (tiled) {
+        // Cached tiles touched by changed data are uploaded again on their next use
+        if (m_new_data || m_new_source) {
+            const QRegion changed = m_new_source ? QRegion(QRect(QPoint(0, 0), data_size))
+                                                 : m_source->changedRegion(n->m_change_count);
+            for (auto& tile : n->m_tiles) {
+                if (changed.intersects(tile.second.m_texture_rect)) {
+                    tile.second.m_valid = false;
+                }
+            }
+            n->m_change_count = m_source->changeCount();
+            m_new_data = false;
+            m_new_source = false;
+        }
+        m_new_geometry = false;
+        updateTiles(n);
+        n->markDirty(QSGNode::DirtyMaterial);
+        return n;
+    }
+
     if (n->firstChild() == nullptr) {
         // Create child node if there is a data source
         n_geom = new QSGGeometryNode();
@@ -280,12 +642,11 @@ QSGNode* ColormappedImage::updatePaintNode(QSGNode* n, QQuickItem::UpdatePaintNo
         n_geom->setFlag(QSGNode::OwnsGeometry);
         m_new_geometry = true;
         // Initialize material
-        material = new QSQColormapMaterial;
+        material = new QSQColormapMaterial(m_source->dataDimensions() == 3);
         material->m_texture_image = m_source->textureProvider()->texture();
+        material->m_texture_cmap = &n->m_texture_cmap;
         n_geom->setMaterial(material);
         n_geom->setFlag(QSGNode::OwnsMaterial);
-        // Force colormap initialization
-        m_new_colormap = true;
         //
         n->appendChildNode(n_geom);
     }
@@ -296,6 +657,17 @@ QSGNode* ColormappedImage::updatePaintNode(QSGNode* n, QQuickItem::UpdatePaintNo
     material = static_cast<QSQColormapMaterial*>(n_geom->material());
     QSGNode::DirtyState dirty_state = QSGNode::DirtyMaterial;
 
+    // Volume data needs the 3D shader, replace the material if the data dimensions changed
+    const bool volume = m_source->dataDimensions() == 3;
+    if (material->m_volume != volume) {
+        auto* previous = material;
+        material = new QSQColormapMaterial(volume);
+        material->m_texture_image = previous->m_texture_image;
+        material->m_texture_cmap = previous->m_texture_cmap;
+        material->setFlag(QSGMaterial::Blending, previous->flags().testFlag(QSGMaterial::Blending));
+        n_geom->setMaterial(material);
+    }
+
     // Check for geometry changes
     if (m_new_geometry) {
         // Map function for view/extent to texture coordinates (single dimension)
@@ -336,18 +708,28 @@ QSGNode* ColormappedImage::updatePaintNode(QSGNode* n, QQuickItem::UpdatePaintNo
         m_new_data = false;
     }
 
-    // Check if the colormap should be updated
-    if (m_new_colormap) {
-        updateColormapTexture(material->m_texture_cmap, m_colormap);
-        m_new_colormap = false;
-    }
-
     // Update material parameters
-    double cmap_margin = .5 / material->m_texture_cmap.getDim(0);
-    material->m_amplitude = (1. - 2.*cmap_margin) / (m_max_value - m_min_value);
-    material->m_offset = (cmap_margin / material->m_amplitude) - m_min_value;
+    // (texture values of integer data types are normalized, scale range accordingly)
+    double cmap_margin = .5 / n->m_texture_cmap.getDim(0);
+    double value_scale = m_source->valueScale();
+    double amplitude = (1. - 2.*cmap_margin) / (m_max_value - m_min_value);
+    material->m_amplitude = amplitude / value_scale;
+    material->m_offset = ((cmap_margin / amplitude) - m_min_value) * value_scale;
     material->m_filter = m_filter;
 
+    // Oldest row of ring buffer data is shown at the bottom
+    const bool ring = m_source->streaming() && m_source->dataHeight() > 0;
+    material->m_row_offset = ring ? static_cast<double>(m_source->streamOffset()) / m_source->dataHeight() : 0.;
+    material->m_row_clamp = ring ? .5 / m_source->dataHeight() : 0.;
+
+    // Slices of volume data only change uniforms, the whole volume stays resident in one 3D texture
+    if (volume) {
+        const int num_slices = numSlices();
+        const double slice = qBound(0., m_slice, static_cast<double>(std::max(num_slices - 1, 0)));
+        material->m_slice_axis = m_slice_axis;
+        material->m_slice = (slice + .5) / std::max(num_slices, 1);
+    }
+
     n->markDirty(dirty_state);
     n_geom->markDirty(dirty_state);
     return n;
@@ -4,6 +4,8 @@
 #include "dataclient.h"
 #include <QVector4D>
 
+class ColormappedImageNode;
+
 class ColormappedImage : public DataClient
 {
     Q_OBJECT
@@ -13,6 +15,13 @@ class ColormappedImage : public DataClient
     Q_PROPERTY(QVector4D extent MEMBER m_extent WRITE setExtent NOTIFY extentChanged)
     Q_PROPERTY(QString colormap MEMBER m_colormap WRITE setColormap NOTIFY colormapChanged)
     Q_PROPERTY(QString filter READ getFilter WRITE setFilter NOTIFY filterChanged)
+    Q_PROPERTY(int tileSize MEMBER m_tile_size WRITE setTileSize NOTIFY tileSizeChanged)
+    Q_PROPERTY(int tileMemoryBudget MEMBER m_tile_budget WRITE setTileMemoryBudget NOTIFY tileMemoryBudgetChanged)
+    Q_PROPERTY(bool autoRange MEMBER m_auto_range WRITE setAutoRange NOTIFY autoRangeChanged)
+    Q_PROPERTY(double autoRangePercentile MEMBER m_auto_range_percentile WRITE setAutoRangePercentile NOTIFY autoRangePercentileChanged)
+    Q_PROPERTY(double slice MEMBER m_slice WRITE setSlice NOTIFY sliceChanged)
+    Q_PROPERTY(int sliceAxis MEMBER m_slice_axis WRITE setSliceAxis NOTIFY sliceAxisChanged)
+    Q_PROPERTY(int numSlices READ numSlices NOTIFY numSlicesChanged)
 
 public:
     explicit ColormappedImage(QQuickItem *parent = nullptr);
@@ -25,6 +34,19 @@ public:
     void setColormap(const QString& colormap);
     void setFilter(const QString& filter);
     QString getFilter() const;
+    // Split 2D data into tiles of tileSize pixels (0 disables tiling), only visible tiles are uploaded and drawn
+    void setTileSize(int size);
+    // Texture memory of cached tiles in MiB, least recently used tiles are evicted first
+    void setTileMemoryBudget(int mib);
+    // Follow the data range, clipped to [p, 100 - p] percentiles of the values (0 uses minimum and maximum)
+    void setAutoRange(bool enabled);
+    void setAutoRangePercentile(double percent);
+    // Show one slice of 3D data, the volume stays resident in a 3D texture so stepping through slices only changes a uniform
+    // (slice is an index along sliceAxis: 0 = depth, 1 = height, 2 = width, fractional slices are interpolated with linear filter)
+    void setSlice(double slice);
+    void setSliceAxis(int axis);
+    int numSlices() const;
+    void setDataSource(QQuickItem* item) override;
 
 signals:
     void minimumValueChanged(double value);
@@ -33,11 +55,21 @@ signals:
     void extentChanged(const QVector4D& extent);
     void colormapChanged(const QString& colormap);
     void filterChanged(const QString& filter);
+    void tileSizeChanged(int size);
+    void tileMemoryBudgetChanged(int mib);
+    void autoRangeChanged(bool enabled);
+    void autoRangePercentileChanged(double percent);
+    void sliceChanged(double slice);
+    void sliceAxisChanged(int axis);
+    void numSlicesChanged();
 
 protected:
     QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* updatePaintNodeData) override;
+    Q_INVOKABLE void updateAutoRange();
 
 private:
+    void updateTiles(ColormappedImageNode* n);
+
     double m_min_value = 0.;
     double m_max_value = 1.;
     QRectF m_view_rect = {0., 0., 1., 1.};
@@ -46,6 +78,12 @@ private:
     bool m_new_colormap = false;
     QSGTexture* m_texture_cmap = nullptr;
     QSGTexture::Filtering m_filter = QSGTexture::Linear;
+    int m_tile_size = 0;
+    int m_tile_budget = 256;
+    bool m_auto_range = false;
+    double m_auto_range_percentile = 0.;
+    double m_slice = 0.;
+    int m_slice_axis = 0;
 };
 
 
@@ -1,6 +1,9 @@
 #ifndef COLORMAPS_H
 #define COLORMAPS_H
 
+#include <QString>
+#include "qsgdatatexture.h"
+
 constexpr double cmap_wjet[] = {
     1.000000, 1.000000, 1.000000,
     0.200000, 0.300000, 1.000000,
@@ -587,4 +590,42 @@ constexpr double cmap_gray[] = {
     1.        , 1.        , 1.
 };
 
+// Fill texture with colormap samples by name, unknown names give gray
+inline void updateColormapTexture(QSGDataTexture<float>& texture, const QString& colormap) {
+    texture.setFiltering(QSGTexture::Linear);
+
+    // Get colormap data pointer and number of samples by name
+    double* data;
+    int numpoints;
+    if (colormap == QStringLiteral("wjet")) {
+        data = const_cast<double*>(cmap_wjet);
+        numpoints = sizeof(cmap_wjet) / (3*sizeof(double));
+    } else if (colormap == QStringLiteral("jet")) {
+        data = const_cast<double*>(cmap_jet);
+        numpoints = sizeof(cmap_jet) / (3*sizeof(double));
+    } else if (colormap == QStringLiteral("hot")) {
+        data = const_cast<double*>(cmap_hot);
+        numpoints = sizeof(cmap_hot) / (3*sizeof(double));
+    } else if (colormap == QStringLiteral("bwr")) {
+        data = const_cast<double*>(cmap_bwr);
+        numpoints = sizeof(cmap_bwr) / (3*sizeof(double));
+    } else if (colormap == QStringLiteral("viridis")) {
+        data = const_cast<double*>(cmap_viridis);
+        numpoints = sizeof(cmap_viridis) / (3*sizeof(double));
+    } else if (colormap == QStringLiteral("ferrugineus")) {
+        data = const_cast<double*>(cmap_ferrugineus);
+        numpoints = sizeof(cmap_ferrugineus) / (3*sizeof(double));
+    } else {
+        data = const_cast<double*>(cmap_gray);
+        numpoints = sizeof(cmap_gray) / (3*sizeof(double));
+    }
+
+    // Copy colormap to data texture
+    float* textureBuffer = texture.allocateData2D(numpoints, 1, 3);
+    for (int i = 0; i < numpoints*3; ++i) {
+        textureBuffer[i] = static_cast<float>(data[i]);
+    }
+    texture.commitData();
+}
+
 #endif // COLORMAPS_H
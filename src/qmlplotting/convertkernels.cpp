@@ -0,0 +1,161 @@
+#include "convertkernels.h"
+#include "parallelfor.h"
+#include "renderstats.h"
+
+#include <vector>
+
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CONVERTKERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+
+// ** scalar **
+
+static void convertToFloatScalar(const double* src, int num_elements, float* dst)
+{
+    for (int i = 0; i < num_elements; ++i) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+}
+
+static void convertFillPointsScalar(const double* src, int num_points, float* dst)
+{
+    for (int i = 0; i < num_points; ++i) {
+        dst[4*i+0] = static_cast<float>(src[2*i+0]);
+        dst[4*i+1] = 0.f;
+        dst[4*i+2] = static_cast<float>(src[2*i+0]);
+        dst[4*i+3] = static_cast<float>(src[2*i+1]);
+    }
+}
+
+
+#ifdef CONVERTKERNELS_X86
+
+// ** SSE2 **
+
+__attribute__((target("sse2")))
+static void convertToFloatSse2(const double* src, int num_elements, float* dst)
+{
+    int i = 0;
+    for (; i + 4 <= num_elements; i += 4) {
+        const __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        const __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+    }
+    convertToFloatScalar(src + i, num_elements - i, dst + i);
+}
+
+__attribute__((target("sse2")))
+static void convertFillPointsSse2(const double* src, int num_points, float* dst)
+{
+    for (int i = 0; i < num_points; ++i) {
+        // (x, y, 0, 0) -> (x, 0, x, y)
+        const __m128 xy = _mm_cvtpd_ps(_mm_loadu_pd(src + 2*i));
+        _mm_storeu_ps(dst + 4*i, _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(1, 0, 2, 0)));
+    }
+}
+
+
+// ** AVX2 **
+
+__attribute__((target("avx2")))
+static void convertToFloatAvx2(const double* src, int num_elements, float* dst)
+{
+    int i = 0;
+    for (; i + 8 <= num_elements; i += 8) {
+        _mm_storeu_ps(dst + i, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i)));
+        _mm_storeu_ps(dst + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4)));
+    }
+    convertToFloatScalar(src + i, num_elements - i, dst + i);
+}
+
+#endif // CONVERTKERNELS_X86
+
+
+// ** dispatch **
+
+struct ConvertKernels {
+    void (*toFloat)(const double*, int, float*);
+    void (*fillPoints)(const double*, int, float*);
+    const char* name;
+};
+
+// Kernels supported by this CPU, scalar first and the preferred variant last
+static std::vector<ConvertKernels> supportedKernels()
+{
+    std::vector<ConvertKernels> supported = {{convertToFloatScalar, convertFillPointsScalar, "scalar"}};
+#ifdef CONVERTKERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        supported.push_back({convertToFloatSse2, convertFillPointsSse2, "sse2"});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        supported.push_back({convertToFloatAvx2, convertFillPointsSse2, "avx2"});
+    }
+#endif
+    return supported;
+}
+
+static const std::vector<ConvertKernels>& variants()
+{
+    static const std::vector<ConvertKernels> supported = supportedKernels();
+    return supported;
+}
+
+static const ConvertKernels& kernels()
+{
+    return variants().back();
+}
+
+void convertToFloat(const double* src, int num_elements, float* dst)
+{
+    RenderStats::addConvertedValues(num_elements);
+    const auto toFloat = kernels().toFloat;
+    if (num_elements <= ParallelGrainSize) {
+        toFloat(src, num_elements, dst);
+        return;
+    }
+    parallelFor(num_elements, ParallelGrainSize, [=](int64_t begin, int64_t end) {
+        toFloat(src + begin, static_cast<int>(end - begin), dst + begin);
+    });
+}
+
+void convertFillPoints(const double* src, int num_points, float* dst)
+{
+    RenderStats::addConvertedValues(2 * num_points);
+    const auto fillPoints = kernels().fillPoints;
+    if (num_points <= ParallelGrainSize / 2) {
+        fillPoints(src, num_points, dst);
+        return;
+    }
+    parallelFor(num_points, ParallelGrainSize / 2, [=](int64_t begin, int64_t end) {
+        fillPoints(src + 2*begin, static_cast<int>(end - begin), dst + 4*begin);
+    });
+}
+
+const char* convertKernelsInstructionSet()
+{
+    return kernels().name;
+}
+
+int convertKernelsNumVariants()
+{
+    return static_cast<int>(variants().size());
+}
+
+const char* convertKernelsVariantName(int variant)
+{
+    return variants().at(static_cast<size_t>(variant)).name;
+}
+
+void convertToFloatVariant(int variant, const double* src, int num_elements, float* dst)
+{
+    variants().at(static_cast<size_t>(variant)).toFloat(src, num_elements, dst);
+}
+
+void convertFillPointsVariant(int variant, const double* src, int num_points, float* dst)
+{
+    variants().at(static_cast<size_t>(variant)).fillPoints(src, num_points, dst);
+}
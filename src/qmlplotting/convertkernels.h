@@ -0,0 +1,24 @@
+#ifndef CONVERTKERNELS_H
+#define CONVERTKERNELS_H
+
+/**
+ * Conversion kernels for geometry and texture data.
+ *
+ * Kernels are selected once at runtime, AVX2 and SSE2 on x86 with a scalar fallback elsewhere.
+ * Large arrays are split across threads with parallelFor.
+ */
+
+// Convert num_elements double values to float
+void convertToFloat(const double* src, int num_elements, float* dst);
+// Convert xy points to fill strip vertices (x, 0), (x, y)
+void convertFillPoints(const double* src, int num_points, float* dst);
+// Name of the selected instruction set
+const char* convertKernelsInstructionSet();
+
+// Single threaded access to all variants supported by this CPU for testing, variant 0 is the scalar reference
+int convertKernelsNumVariants();
+const char* convertKernelsVariantName(int variant);
+void convertToFloatVariant(int variant, const double* src, int num_elements, float* dst);
+void convertFillPointsVariant(int variant, const double* src, int num_points, float* dst);
+
+#endif // CONVERTKERNELS_H
@@ -1,11 +1,16 @@
 #include "dataclient.h"
 
+#include <algorithm>
+
 DataClient::DataClient(QQuickItem *parent)
     : QQuickItem(parent)
     , m_new_geometry(false)
     , m_new_data(false)
     , m_new_source(false)
     , m_source(nullptr)
+    , m_render_stats()
+    , m_commits_coalesced(0)
+    , m_source_generation(0)
 {
 
 }
@@ -14,6 +19,13 @@ DataClient::~DataClient() = default;
 
 void DataClient::dataChanged()
 {
+    // generations merged by the source, plus the previous one if it was not rendered yet
+    const qint64 generation = m_source->generation();
+    m_commits_coalesced += std::max<qint64>(generation - m_source_generation - 1, 0);
+    if (m_new_data) {
+        ++m_commits_coalesced;
+    }
+    m_source_generation = generation;
     m_new_data = true;
     update();
 }
@@ -34,11 +46,20 @@ void DataClient::setDataSource(QQuickItem *item)
         connect(d, &DataSource::dataChanged, this, &DataClient::dataChanged);
     }
     m_source = d;
+    m_source_generation = (d != nullptr) ? d->generation() : 0;
     m_new_source = true;
     emit dataSourceChanged(d);
     update();
 }
 
+void DataClient::setRenderStatsEnabled(bool enabled)
+{
+    if (enabled != m_render_stats.enabled) {
+        m_render_stats.enabled = enabled;
+        emit renderStatsEnabledChanged(enabled);
+    }
+}
+
 void DataClient::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
 {
     QQuickItem::geometryChanged(newGeometry, oldGeometry);
@@ -3,14 +3,24 @@
 
 #include <QQuickItem>
 #include "datasource.h"
+#include "renderstats.h"
 
 class DataClient : public QQuickItem
 {
     Q_OBJECT
     Q_PROPERTY(QQuickItem* dataSource READ dataSource WRITE setDataSource NOTIFY dataSourceChanged)
+    // Performance counters, collected and updated after each updatePaintNode if renderStatsEnabled is set
+    Q_PROPERTY(bool renderStatsEnabled READ renderStatsEnabled WRITE setRenderStatsEnabled NOTIFY renderStatsEnabledChanged)
+    Q_PROPERTY(double paintNodeTime READ paintNodeTime NOTIFY renderStatsChanged)
+    Q_PROPERTY(qint64 verticesGenerated READ verticesGenerated NOTIFY renderStatsChanged)
+    Q_PROPERTY(qint64 textureBytesUploaded READ textureBytesUploaded NOTIFY renderStatsChanged)
+    Q_PROPERTY(qint64 dataConversions READ dataConversions NOTIFY renderStatsChanged)
+    Q_PROPERTY(qint64 commitsCoalesced READ commitsCoalesced NOTIFY renderStatsChanged)
 
 signals:
     void dataSourceChanged(QQuickItem* item);
+    void renderStatsChanged();
+    void renderStatsEnabledChanged(bool enabled);
 
 public:
     explicit DataClient(QQuickItem *parent = nullptr);
@@ -19,6 +29,17 @@ public:
     QQuickItem* dataSource() const {return m_source;}
     virtual void setDataSource(QQuickItem* item);
 
+    // Counters are off by default, every enabled item notifies its counters once per frame
+    bool renderStatsEnabled() const {return m_render_stats.enabled;}
+    void setRenderStatsEnabled(bool enabled);
+    // Duration of the last updatePaintNode in ms and vertices generated by it
+    double paintNodeTime() const {return m_render_stats.paint_time;}
+    qint64 verticesGenerated() const {return m_render_stats.vertices;}
+    // Totals of texture bytes uploaded, values converted to float and data changes merged into a single update
+    qint64 textureBytesUploaded() const {return m_render_stats.upload_bytes;}
+    qint64 dataConversions() const {return m_render_stats.converted_values;}
+    qint64 commitsCoalesced() const {return m_commits_coalesced;}
+
 protected:
     void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) override;
     Q_INVOKABLE void dataChanged();
@@ -27,6 +48,10 @@ protected:
     bool m_new_data;
     bool m_new_source;
     DataSource* m_source;
+    RenderStats m_render_stats;
+    qint64 m_commits_coalesced;
+    // generation of the source at the last data change notification
+    qint64 m_source_generation;
 };
 
 #endif // DATACLIENT_H
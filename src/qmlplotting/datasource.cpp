@@ -1,50 +1,382 @@
 #include <QThread>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QOpenGLContext>
 #include "datasource.h"
 #include "qsgdatatexture.h"
+#include "convertkernels.h"
+#include "imagepyramid.h"
+#include "parallelfor.h"
+#include "renderstats.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <vector>
+#include <limits>
+#include <memory>
+#include <type_traits>
 
 
-class DataTexture : public QSGDataTexture<float>
+// Result of an asynchronous commit, prepared on a worker thread from a snapshot of the data
+struct DataSource::PreparedData
+{
+    qint64 generation = 0;
+    DataSource::DataType type = DataSource::Float64;
+    int dims[3] = {0, 0, 0};
+    int num_dims = 0;
+    // float copy of double data, other types are uploaded directly
+    std::vector<float> values;
+    // copy of other types if levels are prepared, superseded results are shown from their own buffers
+    QByteArray base;
+    // reduced levels of 2D data in texture element type
+    QByteArray levels;
+    int num_levels = 0;
+    DataStatistics statistics;
+    bool has_pyramid = false;
+    MinMaxPyramid pyramid;
+};
+
+// Connects running preparations to their data source, cleared when the source is destroyed
+struct DataSource::PreparationLink
+{
+    QMutex mutex;
+    DataSource* source = nullptr;
+    std::vector<std::shared_ptr<DataSource::PreparedData>> finished;
+};
+
+
+class PreparationTask : public QRunnable
 {
 public:
-    DataTexture(const DataSource *source)
-        : QSGDataTexture<float>()
+    PreparationTask(std::shared_ptr<DataSource::PreparationLink> link, std::shared_ptr<DataSource::PreparedData> prepared,
+                    const QByteArray& snapshot, std::shared_ptr<const void> owner, const void* data,
+                    DataSource::DataType type, const int* dims, int num_dims, ImageReduction mode)
+        : m_link(std::move(link))
+        , m_prepared(std::move(prepared))
+        , m_snapshot(snapshot)
+        , m_owner(std::move(owner))
+        , m_data(data)
+        , m_type(type)
+        , m_num_dims(num_dims)
+        , m_mode(mode)
+    {
+        std::copy(dims, dims + 3, m_dims);
+    }
+
+    void run() override {
+        int64_t num_elements = 1;
+        for (int i = 0; i < m_num_dims; ++i) {
+            num_elements *= m_dims[i];
+        }
+        DataSource::visitData(m_type, m_data, [this, num_elements](const auto* values) {
+            prepare(values, num_elements);
+        });
+        // hand the result to the GUI thread, unless the source is gone
+        QMutexLocker lock(&m_link->mutex);
+        if (m_link->source != nullptr) {
+            m_link->finished.push_back(m_prepared);
+            QMetaObject::invokeMethod(m_link->source, "adoptPrepared", Qt::QueuedConnection);
+        }
+    }
+
+private:
+    template<typename T>
+    void prepare(const T* values, int64_t num_elements) {
+        if (m_num_dims == 1) {
+            // y values of xy data
+            m_prepared->statistics.build(values + 1, num_elements / 2, 2);
+            m_prepared->pyramid.build(values + 1, 2, m_dims[0] / 2);
+            m_prepared->has_pyramid = true;
+        } else {
+            m_prepared->statistics.build(values, num_elements);
+        }
+        convertValues(values, num_elements);
+        prepareLevels(values);
+        if (!std::is_same<T, double>::value && m_prepared->num_levels > 0) {
+            m_prepared->base = QByteArray(reinterpret_cast<const char*>(values), static_cast<int>(num_elements * static_cast<int64_t>(sizeof(T))));
+        }
+    }
+
+    // Double precision is not supported by textures, other types are uploaded from the data directly
+    template<typename T>
+    void convertValues(const T*, int64_t) {}
+    void convertValues(const double* values, int64_t num_elements) {
+        m_prepared->values.resize(static_cast<size_t>(num_elements));
+        convertToFloat(values, static_cast<int>(num_elements), m_prepared->values.data());
+    }
+
+    template<typename S>
+    void prepareLevels(const S* values) {
+        if (m_num_dims != 2 || m_mode == ImageReduction::None) {
+            return;
+        }
+        using T = typename std::conditional<std::is_same<S, double>::value, float, S>::type;
+        std::vector<T> levels;
+        m_prepared->num_levels = buildImagePyramid(values, m_dims[0], m_dims[1], m_mode, levels);
+        m_prepared->levels = QByteArray(reinterpret_cast<const char*>(levels.data()), static_cast<int>(levels.size() * sizeof(T)));
+    }
+
+    std::shared_ptr<DataSource::PreparationLink> m_link;
+    std::shared_ptr<DataSource::PreparedData> m_prepared;
+    // keeps owned data alive while the source reallocates, or external data while the source replaces it
+    QByteArray m_snapshot;
+    std::shared_ptr<const void> m_owner;
+    const void* m_data;
+    DataSource::DataType m_type;
+    int m_dims[3];
+    int m_num_dims;
+    ImageReduction m_mode;
+};
+
+
+class DataTexture : public QSGDynamicTexture
+{
+public:
+    DataTexture(DataSource *source)
+        : QSGDynamicTexture()
         , m_source(source)
     {
     }
     ~DataTexture() override = default;
 
+    int textureId() const override {
+        return m_texture ? m_texture->textureId() : 0;
+    }
+
+    QSize textureSize() const override {
+        return m_texture ? m_texture->textureSize() : QSize();
+    }
+
+    bool hasAlphaChannel() const override {
+        return false;
+    }
+
+    bool hasMipmaps() const override {
+        return false;
+    }
+
+    void bind() override {
+        if (m_texture) {
+            m_texture->setFiltering(filtering());
+            m_texture->setVerticalWrapMode(verticalWrapMode());
+            m_texture->bind();
+        }
+    }
+
     bool updateTexture() override {
+        QMLPLOTTING_TRACE_SCOPE("DataTexture::updateTexture");
         QMutexLocker lock(&m_source_access);
-        if (m_source && m_source->m_new_data) {
-            // copy/convert data to float texture buffer
-            float* data = allocateData(m_source->m_dims, m_source->m_num_dims, 1);
-            int num_elements = 1;
-            for (int i = 0; i < m_source->m_num_dims; ++i) {
-                num_elements *= m_source->m_dims[i];
-            }
-            for (int i = 0; i < num_elements; ++i) {
-                data[i] = m_source->m_data[i];
-            }
-            commitData();
+        if (m_source && m_source->m_new_data && m_source->m_num_dims > 0) {
+            m_source->visitData([this](const auto* data) {
+                upload(data);
+            });
+            m_source->m_new_data = false;
+            m_source->m_dirty_region = QRegion();
             return true;
         }
         return false;
     }
 
     QMutex m_source_access;
-    const DataSource* m_source = nullptr;
+    DataSource* m_source = nullptr;
+
+private:
+    // Prepared data of the shown asynchronous commit, null if data changed otherwise since
+    const DataSource::PreparedData* preparedData() const {
+        const auto& prepared = m_source->m_prepared;
+        return (prepared && prepared->generation == m_source->m_shown_generation) ? prepared.get() : nullptr;
+    }
+
+    // Dirty region if only a part of 1D or 2D data changed, empty region otherwise
+    QRegion partialRegion() const {
+        const QRegion& region = m_source->m_dirty_region;
+        if (m_source->m_num_dims > 2 || region.isEmpty()) {
+            return QRegion();
+        }
+        const int height = (m_source->m_num_dims == 2) ? m_source->m_dims[1] : 1;
+        return region.contains(QRect(0, 0, m_source->m_dims[0], height)) ? QRegion() : region;
+    }
+
+    // Upload directly from data source memory without staging copy
+    template<typename T>
+    void upload(const T* data) {
+        auto* texture = typedTexture<T>();
+        const QRegion region = partialRegion();
+        if (!region.isEmpty()) {
+            const int row_length = m_source->m_dims[0];
+            bool uploaded = true;
+            for (const QRect& rect : region) {
+                const T* first = data + rect.y() * row_length + rect.x();
+                uploaded = uploaded && texture->uploadRegion(first, row_length, rect.x(), rect.y(), rect.width(), rect.height());
+            }
+            if (uploaded) {
+                updateMipLevels(texture, data, region);
+                return;
+            }
+        }
+        // data of a superseded commit with levels
+        const DataSource::PreparedData* prepared = preparedData();
+        if (prepared != nullptr && !prepared->base.isEmpty()) {
+            data = reinterpret_cast<const T*>(prepared->base.constData());
+        }
+        // uploaded from client memory, a pixel buffer would only add a copy on the render thread
+        texture->uploadData(data, m_source->m_dims, m_source->m_num_dims, 1);
+        updateMipLevels(texture, data);
+    }
+
+    // Double precision is not supported by textures, copy/convert data to float texture buffer
+    void upload(const double* data) {
+        auto* texture = typedTexture<float>();
+        const QRegion region = partialRegion();
+        if (!region.isEmpty()) {
+            // convert changed regions only
+            const int row_length = m_source->m_dims[0];
+            bool uploaded = true;
+            for (const QRect& rect : region) {
+                m_region_buffer.resize(static_cast<size_t>(rect.width() * rect.height()));
+                for (int y = 0; y < rect.height(); ++y) {
+                    const double* src = data + (rect.y() + y) * row_length + rect.x();
+                    convertToFloat(src, rect.width(), m_region_buffer.data() + y * rect.width());
+                }
+                uploaded = uploaded && texture->uploadRegion(m_region_buffer.data(), rect.width(), rect.x(), rect.y(), rect.width(), rect.height());
+            }
+            if (uploaded) {
+                updateMipLevels(texture, data, region);
+                return;
+            }
+        }
+        const DataSource::PreparedData* prepared = preparedData();
+        if (prepared != nullptr && !prepared->values.empty()) {
+            // converted on the worker thread, uploaded from client memory like other types
+            texture->uploadData(prepared->values.data(), m_source->m_dims, m_source->m_num_dims, 1);
+            updateMipLevels(texture, data);
+            return;
+        }
+        const int num_elements = numElements();
+        // convert straight into a mapped pixel buffer if enabled, the conversion replaces the copy into the staging buffer
+        if (!uploadMapped(texture, [data, num_elements](float* dst) { convertToFloat(data, num_elements, dst); })) {
+            float* dst = texture->allocateData(m_source->m_dims, m_source->m_num_dims, 1);
+            convertToFloat(data, num_elements, dst);
+            texture->commitData();
+        }
+        updateMipLevels(texture, data);
+    }
+
+    int numElements() const {
+        int num_elements = 1;
+        for (int i = 0; i < m_source->m_num_dims; ++i) {
+            num_elements *= m_source->m_dims[i];
+        }
+        return num_elements;
+    }
+
+    // Fill a mapped pixel buffer of the texture, false if pixel buffers are disabled or mapping failed
+    template<typename Fill>
+    bool uploadMapped(QSGDataTexture<float>* texture, Fill&& fill) {
+        texture->setPixelBuffers(m_source->m_pixel_buffers);
+        T* dst = texture->mapData(m_source->m_dims, m_source->m_num_dims, 1);
+        if (dst == nullptr) {
+            return false;
+        }
+        fill(dst);
+        return texture->unmapData();
+    }
+
+    // Reduced levels of 2D data for zoomed out views. A copy of the levels is kept, after partial uploads
+    // only the blocks depending on the changed region are reduced and uploaded again.
+    template<typename S, typename T>
+    void updateMipLevels(QSGDataTexture<T>* texture, const S* data, const QRegion& region = QRegion()) {
+        auto mode = static_cast<ImageReduction>(m_source->m_reduction);
+        if (m_source->m_num_dims != 2 || m_source->m_streaming) {
+            // ring buffers would rebuild all levels on every append
+            mode = ImageReduction::None;
+        }
+        if (mode == ImageReduction::None) {
+            if (m_has_levels) {
+                texture->setMipLevels(nullptr, 0);
+                m_has_levels = false;
+            }
+            m_levels.clear();
+            return;
+        }
+        const QSize size(m_source->m_dims[0], m_source->m_dims[1]);
+        if (!region.isEmpty() && m_has_levels && m_levels_mode == mode && m_levels_size == size) {
+            updateMipRegion(texture, data, region);
+            return;
+        }
+        const DataSource::PreparedData* prepared = preparedData();
+        if (prepared != nullptr && prepared->num_levels > 0) {
+            m_levels = prepared->levels;
+            m_num_levels = prepared->num_levels;
+        } else {
+            std::vector<T> levels;
+            m_num_levels = buildImagePyramid(data, size.width(), size.height(), mode, levels);
+            m_levels = QByteArray(reinterpret_cast<const char*>(levels.data()), static_cast<int>(levels.size() * sizeof(T)));
+        }
+        m_levels_mode = mode;
+        m_levels_size = size;
+        texture->setMipLevels(reinterpret_cast<const T*>(m_levels.constData()), m_num_levels);
+        m_has_levels = true;
+    }
+
+    template<typename S, typename T>
+    void updateMipRegion(QSGDataTexture<T>* texture, const S* data, const QRegion& region) {
+        T* levels = reinterpret_cast<T*>(m_levels.data());
+        std::vector<ImageRegion> changed;
+        bool uploaded = true;
+        for (const QRect& rect : region) {
+            const int num_levels = updateImagePyramid(data, m_levels_size.width(), m_levels_size.height(), m_levels_mode,
+                                                      {rect.x(), rect.y(), rect.width(), rect.height()}, levels, changed);
+            const T* level = levels;
+            int width = m_levels_size.width();
+            int height = m_levels_size.height();
+            for (int i = 0; i < num_levels; ++i) {
+                width = std::max(width / 2, 1);
+                height = std::max(height / 2, 1);
+                const ImageRegion& r = changed[static_cast<size_t>(i)];
+                if (r.width > 0 && r.height > 0) {
+                    const T* first = level + r.y * width + r.x;
+                    uploaded = uploaded && texture->uploadRegion(first, width, r.x, r.y, r.width, r.height, i + 1);
+                }
+                level += width * height;
+            }
+        }
+        if (!uploaded) {
+            // levels of the last full upload are not in the texture yet
+            texture->setMipLevels(levels, m_num_levels);
+        }
+    }
+
+    // Get texture for element type T, replaces the current texture if the element type changed
+    template<typename T>
+    QSGDataTexture<T>* typedTexture() {
+        auto* texture = dynamic_cast<QSGDataTexture<T>*>(m_texture.get());
+        if (texture == nullptr) {
+            texture = new QSGDataTexture<T>();
+            m_texture.reset(texture);
+            m_has_levels = false;
+        }
+        return texture;
+    }
+
+    std::unique_ptr<QSGTexture> m_texture;
+    std::vector<float> m_region_buffer;
+    bool m_has_levels = false;
+    // copy of the reduced levels in texture element type
+    QByteArray m_levels;
+    int m_num_levels = 0;
+    QSize m_levels_size;
+    ImageReduction m_levels_mode = ImageReduction::None;
 };
 
 
 class DataTextureProvider : public QSGTextureProvider
 {
 public:
-    DataTextureProvider(const DataSource *source)
+    DataTextureProvider(DataSource *source)
         : m_datatexture(new DataTexture(source))
     {
     }
@@ -65,13 +397,42 @@ DataSource::DataSource(QQuickItem *parent)
     : QQuickItem(parent)
     , m_data(nullptr)
     , m_num_dims(0)
+    , m_data_type(Float64)
     , m_data_buffer()
     , m_new_data(false)
+    , m_dirty_region()
+    , m_changes()
+    , m_change_count(0)
+    , m_shown_generation(0)
+    , m_streaming(false)
+    , m_stream_offset(0)
+    , m_stream_length(0)
+    , m_stream_appended(0)
+    , m_stream_revision(0)
+    , m_pyramid_valid(false)
+    , m_statistics_valid(false)
+    , m_statistics_changed(0)
+    , m_reduction(NoReduction)
     , m_provider(nullptr)
+    , m_shared_resources()
+    , m_pixel_buffers(0)
+    , m_async_commit(false)
+    , m_frames_in_flight(2)
+    , m_preparations_running(0)
+    , m_preparation_pending(false)
+    , m_generation(0)
+    , m_prepared()
+    , m_preparation_link(std::make_shared<PreparationLink>())
+    , m_notify_pending(false)
+    , m_commits_coalesced(0)
+    , m_producer_back(0)
+    , m_producer_front(1)
+    , m_producer_ready(2)
 {
     for (int& m_dim : m_dims) {
         m_dim = 0;
     }
+    m_preparation_link->source = this;
 }
 
 DataSource::~DataSource()
@@ -82,6 +443,9 @@ DataSource::~DataSource()
         m_provider->m_datatexture->m_source = nullptr;
         m_provider->deleteLater();
     }
+    // running preparations finish without result
+    QMutexLocker lock(&m_preparation_link->mutex);
+    m_preparation_link->source = nullptr;
 }
 
 bool DataSource::isTextureProvider() const
@@ -97,22 +461,171 @@ QSGTextureProvider* DataSource::textureProvider() const
     }
     if (m_provider == nullptr) {
         // TODO: use destroyed signal instead of m_provider for cleanup?
-        const_cast<DataSource*>(this)->m_provider = new DataTextureProvider(this);
+        auto* self = const_cast<DataSource*>(this);
+        self->m_provider = new DataTextureProvider(self);
         m_provider->m_datatexture->updateTexture();
     }
     return m_provider;
 }
 
+void DataSource::setDataType(DataType type)
+{
+    if (type == m_data_type) {
+        return;
+    }
+    // existing data can not be reinterpreted, reset to empty data
+    m_data_type = type;
+    m_data = nullptr;
+    m_data_buffer.clear();
+    if (m_num_dims != 0) {
+        m_num_dims = 0;
+        m_dims[0] = m_dims[1] = m_dims[2] = 0;
+        emit dataimensionsChanged();
+        emit dataSizeChanged();
+    }
+    emit dataTypeChanged(m_data_type);
+    commitData();
+}
+
+void DataSource::setReduction(Reduction reduction)
+{
+    if (reduction == m_reduction) {
+        return;
+    }
+    m_reduction = reduction;
+    emit reductionChanged(m_reduction);
+    // levels are built on upload
+    if (m_num_dims == 2) {
+        commitData();
+    }
+}
+
+void DataSource::setPixelBuffers(int count)
+{
+    count = qBound(0, count, static_cast<int>(QSGDataTexture<float>::MaxPixelBuffers));
+    if (count != m_pixel_buffers) {
+        m_pixel_buffers = count;
+        emit pixelBuffersChanged(m_pixel_buffers);
+    }
+}
+
+void DataSource::setAsyncCommit(bool enabled)
+{
+    if (enabled != m_async_commit) {
+        m_async_commit = enabled;
+        emit asyncCommitChanged(m_async_commit);
+    }
+}
+
+void DataSource::setFramesInFlight(int frames)
+{
+    frames = std::max(frames, 1);
+    if (frames != m_frames_in_flight) {
+        m_frames_in_flight = frames;
+        emit framesInFlightChanged(m_frames_in_flight);
+        startPreparation();
+    }
+}
+
+int DataSource::elementSize(DataType type)
+{
+    switch (type) {
+    case Float32:
+        return static_cast<int>(sizeof(float));
+    case UInt16:
+        return static_cast<int>(sizeof(uint16_t));
+    case Int16:
+        return static_cast<int>(sizeof(int16_t));
+    case UInt8:
+        return static_cast<int>(sizeof(uint8_t));
+    case Int32:
+        return static_cast<int>(sizeof(int32_t));
+    default:
+        return static_cast<int>(sizeof(double));
+    }
+}
+
+double DataSource::valueScale() const
+{
+    switch (m_data_type) {
+    case UInt16:
+        return QSGDataTexture<uint16_t>::valueScale();
+    case Int16:
+        return QSGDataTexture<int16_t>::valueScale();
+    case UInt8:
+        return QSGDataTexture<uint8_t>::valueScale();
+    case Int32:
+        return QSGDataTexture<int32_t>::valueScale();
+    default:
+        return 1.;
+    }
+}
+
+void DataSource::switchDataType(DataType type)
+{
+    // change element type for data that is about to be set, keeps current data
+    if (type != m_data_type) {
+        m_data_type = type;
+        emit dataTypeChanged(m_data_type);
+    }
+}
+
+template<typename T>
+static T convertValue(double value)
+{
+    if (std::is_integral<T>::value) {
+        // round and saturate for integer types
+        return static_cast<T>(qBound<double>(std::numeric_limits<T>::lowest(), std::round(value), std::numeric_limits<T>::max()));
+    }
+    return static_cast<T>(value);
+}
+
+template<typename T>
+static void convertArray(const double* src, T* dst, int num_elements)
+{
+    parallelFor(num_elements, ParallelGrainSize, [=](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            dst[i] = convertValue<T>(src[i]);
+        }
+    });
+}
+
+static void convertArray(const double* src, float* dst, int num_elements)
+{
+    convertToFloat(src, num_elements, dst);
+}
+
+void DataSource::convertFromFloat64(const double *src, int num_elements)
+{
+    switch (m_data_type) {
+    case Float32:
+        convertArray(src, static_cast<float*>(m_data), num_elements);
+        break;
+    case UInt16:
+        convertArray(src, static_cast<uint16_t*>(m_data), num_elements);
+        break;
+    case Int16:
+        convertArray(src, static_cast<int16_t*>(m_data), num_elements);
+        break;
+    case UInt8:
+        convertArray(src, static_cast<uint8_t*>(m_data), num_elements);
+        break;
+    case Int32:
+        convertArray(src, static_cast<int32_t*>(m_data), num_elements);
+        break;
+    default:
+        convertArray(src, static_cast<double*>(m_data), num_elements);
+        break;
+    }
+}
+
 bool DataSource::copyFloat64Array1D(const QByteArray& data, int size)
 {
     if (size * static_cast<int>(sizeof(double)) > data.size()) {
         return false;
     }
-    auto p_src = reinterpret_cast<const double*>(data.constData());
-    auto p_dst = static_cast<double*>(allocateData1D(size));
-    for (decltype(size) i = 0; i < size; ++i) {
-        p_dst[i] = p_src[i];
-    }
+    allocateBuffer(&size, 1);
+    convertFromFloat64(reinterpret_cast<const double*>(data.constData()), size);
     return commitData();
 }
 
@@ -121,15 +634,45 @@ bool DataSource::copyFloat64Array2D(const QByteArray& data, int width, int heigh
     if (width * height * static_cast<int>(sizeof(double)) > data.size()) {
         return false;
     }
-    auto p_src = reinterpret_cast<const double*>(data.constData());
-    auto p_dst = static_cast<double*>(allocateData2D(width, height));
-    for (int i = 0; i < width * height; ++i) {
-        p_dst[i] = p_src[i];
+    int dims[] = {width, height};
+    allocateBuffer(dims, 2);
+    convertFromFloat64(reinterpret_cast<const double*>(data.constData()), width * height);
+    return commitData();
+}
+
+bool DataSource::copyArray1D(const QByteArray& data, int size, DataType type)
+{
+    if (size * elementSize(type) > data.size()) {
+        return false;
+    }
+    switchDataType(type);
+    void* dst = allocateBuffer(&size, 1);
+    std::memcpy(dst, data.constData(), static_cast<size_t>(size * elementSize(type)));
+    return commitData();
+}
+
+bool DataSource::copyArray2D(const QByteArray& data, int width, int height, DataType type)
+{
+    if (width * height * elementSize(type) > data.size()) {
+        return false;
     }
+    switchDataType(type);
+    int dims[] = {width, height};
+    void* dst = allocateBuffer(dims, 2);
+    std::memcpy(dst, data.constData(), static_cast<size_t>(width * height * elementSize(type)));
     return commitData();
 }
 
-bool DataSource::setData(double *data, const int *dims, int num_dims)
+bool DataSource::setData(void *data, const int *dims, int num_dims)
+{
+    if (!setShape(data, dims, num_dims)) {
+        return false;
+    }
+    commitData();
+    return true;
+}
+
+bool DataSource::setShape(void* data, const int* dims, int num_dims)
 {
     if (num_dims <= 0 || num_dims > 3) {
         qWarning("DataSource::setData invalid number of dimensions");
@@ -148,81 +691,495 @@ bool DataSource::setData(double *data, const int *dims, int num_dims)
         }
     }
     m_data = data;
+    if (m_streaming) {
+        // data was replaced, leave ring buffer mode
+        m_streaming = false;
+        m_stream_offset = 0;
+        m_stream_length = 0;
+        emit streamChanged();
+    }
     if (num_dims_changed) {
         emit dataimensionsChanged();
     }
     if (size_changed) {
         emit dataSizeChanged();
     }
-    commitData();
     return true;
 }
 
 bool DataSource::setData1D(void* data, int size) {
-    return setData(reinterpret_cast<double*>(data), &size, 1);
+    return setData(data, &size, 1);
 }
 
 bool DataSource::setData2D(void* data, int width, int height) {
     int dims[] = {width, height};
-    return setData(reinterpret_cast<double*>(data), dims, 2);
+    return setData(data, dims, 2);
 }
 
 bool DataSource::setData3D(void* data, int width, int height, int depth){
     int dims[] = {width, height, depth};
-    return setData(reinterpret_cast<double*>(data), dims, 3);
+    return setData(data, dims, 3);
 }
 
-void* DataSource::allocateData1D(int size)
+bool DataSource::setData1D(void* data, int size, DataType type) {
+    switchDataType(type);
+    return setData1D(data, size);
+}
+
+bool DataSource::setData2D(void* data, int width, int height, DataType type) {
+    switchDataType(type);
+    return setData2D(data, width, height);
+}
+
+bool DataSource::setData3D(void* data, int width, int height, int depth, DataType type) {
+    switchDataType(type);
+    return setData3D(data, width, height, depth);
+}
+
+void* DataSource::allocateData(const int* dims, int num_dims)
 {
-    int num_bytes = size * static_cast<int>(sizeof(double));
+    void* data = allocateBuffer(dims, num_dims);
+    commitData();
+    return data;
+}
+
+void* DataSource::allocateBuffer(const int* dims, int num_dims)
+{
+    int num_bytes = elementSize();
+    for (int i = 0; i < num_dims; ++i) {
+        num_bytes *= dims[i];
+    }
     if (m_data_buffer.size() != num_bytes) {
         m_data_buffer.resize(num_bytes);
     }
-    auto* data = reinterpret_cast<double*>(m_data_buffer.data());
-    setData(data, &size, 1);
+    void* data = m_data_buffer.data();
+    setShape(data, dims, num_dims);
     return data;
 }
 
+void* DataSource::allocateData1D(int size)
+{
+    return allocateData(&size, 1);
+}
+
 void* DataSource::allocateData2D(int width, int height)
 {
-    int num_bytes = width * height * static_cast<int>(sizeof(double));
-    if (m_data_buffer.size() != num_bytes) {
-        m_data_buffer.resize(num_bytes);
-    }
     int dims[] = {width, height};
-    auto* data = reinterpret_cast<double*>(m_data_buffer.data());
-    setData(data, dims, 2);
-    return data;
+    return allocateData(dims, 2);
 }
 
 void* DataSource::allocateData3D(int width, int height, int depth)
 {
-    int num_bytes = width * height * depth * static_cast<int>(sizeof(double));
-    if (m_data_buffer.size() != num_bytes) {
-        m_data_buffer.resize(num_bytes);
-    }
     int dims[] = {width, height, depth};
-    auto* data = reinterpret_cast<double*>(m_data_buffer.data());
-    setData(data, dims, 3);
-    return data;
+    return allocateData(dims, 3);
+}
+
+void* DataSource::allocateData1D(int size, DataType type)
+{
+    switchDataType(type);
+    return allocateData1D(size);
+}
+
+void* DataSource::allocateData2D(int width, int height, DataType type)
+{
+    switchDataType(type);
+    return allocateData2D(width, height);
+}
+
+void* DataSource::allocateData3D(int width, int height, int depth, DataType type)
+{
+    switchDataType(type);
+    return allocateData3D(width, height, depth);
 }
 
 bool DataSource::commitData()
 {
-    m_new_data = true;
+    ++m_generation;
+    m_pyramid_valid = false;
+    m_statistics_valid = false;
+    if (m_async_commit && m_num_dims > 0 && m_data != nullptr) {
+        // start from the event loop, allocated data is usually filled after commit
+        if (!m_preparation_pending) {
+            m_preparation_pending = true;
+            QMetaObject::invokeMethod(this, "startPreparation", Qt::QueuedConnection);
+        }
+        return true;
+    }
+    m_prepared.reset();
+    markDirty(QRect(0, 0, m_dims[0], (m_num_dims == 2) ? m_dims[1] : 1));
+    ++m_stream_revision;
+    m_statistics_changed += numElements();
+    scheduleDataChanged();
+    return true;
+}
+
+void DataSource::scheduleDataChanged()
+{
+    // one notification per event loop iteration, clients render the latest generation at most once per frame
+    if (m_notify_pending) {
+        ++m_commits_coalesced;
+        emit commitsCoalescedChanged(m_commits_coalesced);
+        return;
+    }
+    m_notify_pending = true;
+    QMetaObject::invokeMethod(this, "notifyDataChanged", Qt::QueuedConnection);
+}
+
+void DataSource::notifyDataChanged()
+{
+    if (!m_notify_pending) {
+        return;
+    }
+    m_notify_pending = false;
     emit dataChanged();
+    // rescanning all data for every append or partial commit would cost more than the changes
+    if (m_statistics_changed >= numElements()) {
+        m_statistics_changed = 0;
+        emit statisticsChanged();
+    }
+}
+
+void DataSource::markDirty(const QRect& rect)
+{
+    m_new_data = true;
+    m_dirty_region += rect;
+    m_shown_generation = m_generation;
+    // a few changes are enough for clients rendering at display rate
+    constexpr size_t max_changes = 16;
+    m_changes.push_back(rect);
+    if (m_changes.size() > max_changes) {
+        m_changes.pop_front();
+    }
+    ++m_change_count;
+}
+
+QRegion DataSource::changedRegion(qint64 since) const
+{
+    const qint64 count = m_change_count - since;
+    if (count <= 0) {
+        return QRegion();
+    }
+    if (count > static_cast<qint64>(m_changes.size())) {
+        return QRect(0, 0, m_dims[0], (m_num_dims == 2) ? m_dims[1] : 1);
+    }
+    QRegion region;
+    for (auto it = m_changes.end() - count; it != m_changes.end(); ++it) {
+        region += *it;
+    }
+    return region;
+}
+
+bool DataSource::commitRegion(int x, int y, int width, int height)
+{
+    // partial updates are limited to 1D and 2D data, asynchronous commits always prepare all data
+    if (m_num_dims > 2 || m_async_commit) {
+        return commitData();
+    }
+    const QRect bounds(0, 0, m_dims[0], (m_num_dims == 2) ? m_dims[1] : 1);
+    const QRect region = QRect(x, y, width, height).intersected(bounds);
+    if (region.isEmpty()) {
+        return false;
+    }
+    ++m_generation;
+    markDirty(region);
+    ++m_stream_revision;
+    m_pyramid_valid = false;
+    m_statistics_valid = false;
+    m_statistics_changed += static_cast<qint64>(region.width()) * region.height();
+    scheduleDataChanged();
+    return true;
+}
+
+void* DataSource::allocateStream1D(int size)
+{
+    void* data = allocateBuffer(&size, 1);
+    startStream();
+    commitData();
+    return data;
+}
+
+void* DataSource::allocateStream2D(int width, int height)
+{
+    int dims[] = {width, height};
+    void* data = allocateBuffer(dims, 2);
+    startStream();
+    commitData();
+    return data;
+}
+
+void DataSource::startStream()
+{
+    // start with an empty, zero initialized ring buffer
+    std::memset(m_data, 0, static_cast<size_t>(m_data_buffer.size()));
+    m_streaming = true;
+    m_stream_offset = 0;
+    m_stream_length = 0;
+    m_stream_appended = 0;
+    ++m_stream_revision;
+    emit streamChanged();
+}
+
+bool DataSource::append(const QByteArray& data)
+{
+    const int entry_bytes = ((m_num_dims == 2) ? m_dims[0] : 1) * elementSize();
+    if (entry_bytes <= 0) {
+        return false;
+    }
+    return appendData(data.constData(), data.size() / entry_bytes);
+}
+
+bool DataSource::appendData(const void* data, int count)
+{
+    const int capacity = streamCapacity();
+    if (!m_streaming || capacity <= 0 || data == nullptr || count <= 0) {
+        return false;
+    }
+    const int entry_size = (m_num_dims == 2) ? m_dims[0] : 1;
+    const size_t entry_bytes = static_cast<size_t>(entry_size * elementSize());
+    auto* src = static_cast<const char*>(data);
+
+    // only the most recent entries fit into the ring buffer
+    if (count > capacity) {
+        src += static_cast<size_t>(count - capacity) * entry_bytes;
+        count = capacity;
+    }
+
+    // copy in up to two parts if the ring buffer wraps around
+    ++m_generation;
+    int write_pos = (m_stream_offset + m_stream_length) % capacity;
+    int remaining = count;
+    while (remaining > 0) {
+        const int n = std::min(remaining, capacity - write_pos);
+        std::memcpy(static_cast<char*>(m_data) + static_cast<size_t>(write_pos) * entry_bytes, src, static_cast<size_t>(n) * entry_bytes);
+        if (m_num_dims == 2) {
+            markDirty(QRect(0, write_pos, entry_size, n));
+        } else {
+            markDirty(QRect(write_pos, 0, n, 1));
+            if (m_pyramid_valid && !m_pyramid.isEmpty()) {
+                // keep min/max index of xy data up to date, covers all points touched by the new elements
+                visitData([this, write_pos, n](const auto* values) {
+                    m_pyramid.update(values + 1, 2, write_pos / 2, (write_pos + n + 1) / 2);
+                });
+            }
+        }
+        src += static_cast<size_t>(n) * entry_bytes;
+        write_pos = (write_pos + n) % capacity;
+        remaining -= n;
+    }
+
+    // advance ring buffer, drop oldest entries if full
+    const int overflow = std::max(m_stream_length + count - capacity, 0);
+    m_stream_offset = (m_stream_offset + overflow) % capacity;
+    m_stream_length = std::min(m_stream_length + count, capacity);
+    m_stream_appended += count;
+    m_statistics_valid = false;
+    m_statistics_changed += static_cast<qint64>(count) * entry_size;
+    emit streamChanged();
+    scheduleDataChanged();
     return true;
 }
 
+const MinMaxPyramid& DataSource::minMaxPyramid()
+{
+    if (!m_pyramid_valid) {
+        if (m_num_dims == 1 && m_data != nullptr) {
+            visitData([this](const auto* data) {
+                m_pyramid.build(data + 1, 2, m_dims[0] / 2);
+            });
+        } else {
+            m_pyramid.clear();
+        }
+        m_pyramid_valid = true;
+    }
+    return m_pyramid;
+}
+
+const DataStatistics& DataSource::statistics()
+{
+    if (!m_statistics_valid) {
+        if (m_num_dims > 0 && m_data != nullptr) {
+            const int64_t num_elements = numElements();
+            visitData([this, num_elements](const auto* data) {
+                if (m_num_dims == 1) {
+                    // y values of xy data, like the min/max pyramid
+                    m_statistics.build(data + 1, num_elements / 2, 2);
+                } else {
+                    m_statistics.build(data, num_elements);
+                }
+            });
+        } else {
+            m_statistics.clear();
+        }
+        m_statistics_valid = true;
+    }
+    return m_statistics;
+}
+
+qint64 DataSource::numElements() const
+{
+    qint64 num_elements = (m_num_dims > 0) ? 1 : 0;
+    for (int i = 0; i < m_num_dims; ++i) {
+        num_elements *= m_dims[i];
+    }
+    return num_elements;
+}
+
 bool DataSource::ownsData()
 {
-    return m_data == reinterpret_cast<double*>(m_data_buffer.data());
+    return m_data == m_data_buffer.constData() || m_data == m_producer_buffers[m_producer_front].data.constData();
+}
+
+void* DataSource::allocateBackBuffer(const int* dims, int num_dims, DataType type)
+{
+    if (num_dims <= 0 || num_dims > 3) {
+        qWarning("DataSource::allocateBackBuffer invalid number of dimensions");
+        return nullptr;
+    }
+    ProducerBuffer& buffer = m_producer_buffers[m_producer_back];
+    int num_bytes = elementSize(type);
+    for (int i = 0; i < 3; ++i) {
+        buffer.dims[i] = (i < num_dims) ? dims[i] : 0;
+        num_bytes *= (i < num_dims) ? dims[i] : 1;
+    }
+    buffer.num_dims = num_dims;
+    buffer.type = type;
+    if (buffer.data.size() != num_bytes) {
+        buffer.data.resize(num_bytes);
+    }
+    return buffer.data.data();
+}
+
+void* DataSource::allocateBackBuffer1D(int size, DataType type)
+{
+    return allocateBackBuffer(&size, 1, type);
+}
+
+void* DataSource::allocateBackBuffer2D(int width, int height, DataType type)
+{
+    int dims[] = {width, height};
+    return allocateBackBuffer(dims, 2, type);
+}
+
+void* DataSource::allocateBackBuffer3D(int width, int height, int depth, DataType type)
+{
+    int dims[] = {width, height, depth};
+    return allocateBackBuffer(dims, 3, type);
+}
+
+void DataSource::publishBackBuffer()
+{
+    // swap back buffer with the ready buffer, which is either unused or a published buffer that was never adopted
+    const int previous = m_producer_ready.exchange(m_producer_back | ProducerPublished);
+    m_producer_back = previous & ProducerIndexMask;
+    // an adoption is still pending if the previous buffer was not adopted, publishes are coalesced
+    if ((previous & ProducerPublished) == 0) {
+        QMetaObject::invokeMethod(this, "adoptBackBuffer", Qt::QueuedConnection);
+    }
+}
+
+void DataSource::adoptBackBuffer()
+{
+    // the producer only sets the published flag, so it is still set on exchange
+    if ((m_producer_ready.load() & ProducerPublished) == 0) {
+        return;
+    }
+    m_producer_front = m_producer_ready.exchange(m_producer_front) & ProducerIndexMask;
+    ProducerBuffer& buffer = m_producer_buffers[m_producer_front];
+    switchDataType(buffer.type);
+    setShape(buffer.data.data(), buffer.dims, buffer.num_dims);
+    commitData();
+}
+
+void DataSource::startPreparation()
+{
+    if (!m_preparation_pending || m_preparations_running >= m_frames_in_flight) {
+        // started again when a running preparation finishes
+        return;
+    }
+    m_preparation_pending = false;
+    if (m_num_dims <= 0 || m_data == nullptr) {
+        return;
+    }
+    // owned buffers are shared with the task, reallocation detaches instead of freeing them
+    QByteArray snapshot;
+    std::shared_ptr<const void> owner;
+    if (m_data == m_data_buffer.constData()) {
+        snapshot = m_data_buffer;
+    } else if (m_data == m_producer_buffers[m_producer_front].data.constData()) {
+        snapshot = m_producer_buffers[m_producer_front].data;
+    } else {
+        owner = m_data_owner;
+    }
+    auto prepared = std::make_shared<PreparedData>();
+    prepared->generation = m_generation;
+    prepared->type = m_data_type;
+    prepared->num_dims = m_num_dims;
+    std::copy(m_dims, m_dims + 3, prepared->dims);
+    // ring buffers have no levels, see DataTexture::updateMipLevels
+    const auto mode = m_streaming ? ImageReduction::None : static_cast<ImageReduction>(m_reduction);
+    ++m_preparations_running;
+    QThreadPool::globalInstance()->start(new PreparationTask(m_preparation_link, prepared, snapshot, owner, m_data,
+                                                             m_data_type, m_dims, m_num_dims, mode));
+}
+
+bool DataSource::isSelfContained(const PreparedData& prepared) const
+{
+    // superseded results are shown without converting data or building levels on the render thread, other types
+    // than double are uploaded from the data (newer data of the same shape) unless levels need a matching copy
+    const bool same_shape = prepared.type == m_data_type && prepared.num_dims == m_num_dims
+            && std::equal(m_dims, m_dims + 3, prepared.dims);
+    const bool has_base = (m_data_type == Float64) ? !prepared.values.empty() : !prepared.base.isEmpty();
+    const bool levels = m_num_dims == 2 && !m_streaming && m_reduction != NoReduction;
+    return same_shape && (has_base || (m_data_type != Float64 && !levels));
+}
+
+void DataSource::adoptPrepared()
+{
+    std::vector<std::shared_ptr<PreparedData>> finished;
+    {
+        QMutexLocker lock(&m_preparation_link->mutex);
+        finished.swap(m_preparation_link->finished);
+    }
+    m_preparations_running -= static_cast<int>(finished.size());
+    // the newest result is shown even if commits followed, clients would starve if commits come faster than
+    // preparations finish. A preparation of the latest commit is pending then.
+    std::shared_ptr<PreparedData> newest;
+    for (auto& prepared : finished) {
+        if (!newest || prepared->generation > newest->generation) {
+            newest = prepared;
+        }
+    }
+    if (newest && newest->generation == m_generation) {
+        m_prepared = newest;
+        m_statistics = std::move(newest->statistics);
+        m_statistics_valid = true;
+        m_statistics_changed = 0;
+        if (newest->has_pyramid) {
+            m_pyramid = std::move(newest->pyramid);
+            m_pyramid_valid = true;
+        }
+        markDirty(QRect(0, 0, m_dims[0], (m_num_dims == 2) ? m_dims[1] : 1));
+        ++m_stream_revision;
+        m_notify_pending = false;
+        emit dataChanged();
+        emit statisticsChanged();
+        emit dataReady();
+    } else if (newest && newest->generation > m_shown_generation && isSelfContained(*newest)) {
+        // superseded results are uploaded from their own buffers, statistics and pyramid stay with the latest data
+        m_prepared = newest;
+        markDirty(QRect(0, 0, m_dims[0], (m_num_dims == 2) ? m_dims[1] : 1));
+        m_shown_generation = newest->generation;
+        ++m_stream_revision;
+        m_notify_pending = false;
+        emit dataChanged();
+    }
+    startPreparation();
 }
 
 bool DataSource::setTestData1D()
 {
     int size = 512;
-    auto* d = reinterpret_cast<double*>(allocateData1D(2*size));
+    std::vector<double> d(2*size);
 
     // gauss + noise
     for (int ix = 0; ix < size; ++ix) {
@@ -231,13 +1188,16 @@ bool DataSource::setTestData1D()
         d[2*ix+0] = x;
         d[2*ix+1] = exp(-(x*x)*5.) * (1. + .2 * (r-.5));
     }
-    return true;
+    int num_values = 2*size;
+    allocateBuffer(&num_values, 1);
+    convertFromFloat64(d.data(), 2*size);
+    return commitData();
 }
 
 bool DataSource::setTestData2D()
 {
     int w = 512, h = 512;
-    auto* d = reinterpret_cast<double*>(allocateData2D(w, h));
+    std::vector<double> d(w*h);
 
     // gauss + noise
     for (int iy = 0; iy < h; ++iy) {
@@ -255,5 +1215,8 @@ bool DataSource::setTestData2D()
             d[iy*w + ix] = x;
         }
     }
-    return true;
+    int dims[] = {w, h};
+    allocateBuffer(dims, 2);
+    convertFromFloat64(d.data(), w*h);
+    return commitData();
 }
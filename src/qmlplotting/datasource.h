@@ -5,6 +5,15 @@
 #include <QSGTextureProvider>
 #include <QSGDynamicTexture>
 #include <QByteArray>
+#include <QRegion>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include "minmaxpyramid.h"
+#include "datastatistics.h"
+#include "sharedresources.h"
 
 class DataTexture;
 class DataTextureProvider;
@@ -17,50 +26,280 @@ class DataSource : public QQuickItem
     Q_PROPERTY(int dataWidth READ dataWidth NOTIFY dataSizeChanged)
     Q_PROPERTY(int dataHeight READ dataHeight  NOTIFY dataSizeChanged)
     Q_PROPERTY(int dataDepth READ dataDepth  NOTIFY dataSizeChanged)
+    Q_PROPERTY(DataType dataType READ dataType WRITE setDataType NOTIFY dataTypeChanged)
+    Q_PROPERTY(bool streaming READ streaming NOTIFY streamChanged)
+    Q_PROPERTY(int streamOffset READ streamOffset NOTIFY streamChanged)
+    Q_PROPERTY(int streamLength READ streamLength NOTIFY streamChanged)
+    Q_PROPERTY(Reduction reduction READ reduction WRITE setReduction NOTIFY reductionChanged)
+    Q_PROPERTY(double dataMinimum READ dataMinimum NOTIFY statisticsChanged)
+    Q_PROPERTY(double dataMaximum READ dataMaximum NOTIFY statisticsChanged)
+    Q_PROPERTY(double dataMean READ dataMean NOTIFY statisticsChanged)
+    Q_PROPERTY(int pixelBuffers MEMBER m_pixel_buffers WRITE setPixelBuffers NOTIFY pixelBuffersChanged)
+    Q_PROPERTY(qint64 generation READ generation NOTIFY dataChanged)
+    Q_PROPERTY(qint64 commitsCoalesced READ commitsCoalesced NOTIFY commitsCoalescedChanged)
+    Q_PROPERTY(bool asyncCommit MEMBER m_async_commit WRITE setAsyncCommit NOTIFY asyncCommitChanged)
+    Q_PROPERTY(int framesInFlight MEMBER m_frames_in_flight WRITE setFramesInFlight NOTIFY framesInFlightChanged)
 
 public:
+    enum DataType {
+        Float64,
+        Float32,
+        UInt16,
+        Int16,
+        UInt8,
+        Int32
+    };
+    Q_ENUM(DataType)
+
+    // Reduction of the texture pyramid of 2D data, the level is selected by the zoom of the view
+    enum Reduction {
+        NoReduction,
+        MeanReduction,
+        MaxReduction,
+        MinReduction,
+        PeakReduction   // value farthest from zero, preserves sparse peaks of both signs
+    };
+    Q_ENUM(Reduction)
+
     explicit DataSource(QQuickItem *parent = nullptr);
     ~DataSource() override;
 
     bool isTextureProvider() const override;
     QSGTextureProvider *textureProvider() const override;
 
+    int dataDimensions() const {return m_num_dims;}
     int dataWidth() const {return m_dims[0];}
     int dataHeight() const {return m_dims[1];}
     int dataDepth() const {return m_dims[2];}
+    DataType dataType() const {return m_data_type;}
+    void setDataType(DataType type);
+    Reduction reduction() const {return m_reduction;}
+    void setReduction(Reduction reduction);
+
+    // Counts every change of the data. dataChanged is emitted once per event loop iteration for all changes
+    // since the last notification, commitsCoalesced counts changes merged into a previous notification.
+    qint64 generation() const {return m_generation;}
+    qint64 commitsCoalesced() const {return m_commits_coalesced;}
+    // Counts changed regions. changedRegion returns the region (elements of 1D data in x, rows of 2D data in y)
+    // changed since a client saw changeCount, the whole data if the change is too old to be tracked.
+    qint64 changeCount() const {return m_change_count;}
+    QRegion changedRegion(qint64 since) const;
+
+    // Render resources shared by the clients of this source, render thread only
+    SharedResources& sharedResources() {return m_shared_resources;}
+
+    // Number of pixel buffer objects for full texture uploads of Float64 data (0 to 3), values are converted
+    // straight into mapped buffers and transferred asynchronously. Other types and values converted by
+    // asynchronous commits need no conversion on the render thread and are always uploaded from client memory,
+    // as with 0.
+    void setPixelBuffers(int count);
+
+    // With asynchronous commits texture buffers, mip levels, statistics and the min/max pyramid are prepared
+    // on a worker thread, dataChanged and dataReady are emitted when they are done. Committed data must not be
+    // modified before dataReady. At most framesInFlight preparations run at once, further commits are coalesced.
+    // dataReady is emitted once the latest commit is prepared. Under continuous commits, results of superseded
+    // commits are shown from their own buffers (dataChanged only) while the latest commit is prepared.
+    void setAsyncCommit(bool enabled);
+    void setFramesInFlight(int frames);
+
+    // Size of a single data element in bytes
+    int elementSize() const {return elementSize(m_data_type);}
+    static int elementSize(DataType type);
+    // Factor between data values and values sampled from the texture (normalized integer formats)
+    double valueScale() const;
+
+    // Ring buffer state, offset and length count elements of 1D data or rows of 2D data
+    bool streaming() const {return m_streaming;}
+    int streamOffset() const {return m_stream_offset;}
+    int streamLength() const {return m_stream_length;}
+    int streamCapacity() const {return (m_num_dims == 2) ? m_dims[1] : m_dims[0];}
+    // Total number of appended entries, revision changes whenever data is replaced other than by appending
+    qint64 streamAppended() const {return m_stream_appended;}
+    int streamRevision() const {return m_stream_revision;}
+    bool appendData(const void* data, int count);
+
+    // Call visitor with a typed const pointer to the data
+    template<typename Visitor>
+    void visitData(Visitor&& visitor) const;
+    template<typename Visitor>
+    static void visitData(DataType type, const void* data, Visitor&& visitor);
+
+    // Min/max index of the y values of 1D xy data, built on first access after each commit
+    const MinMaxPyramid& minMaxPyramid();
+
+    // Statistics of all finite data values (y values of 1D xy data), computed on first access after each commit.
+    // statisticsChanged is emitted for full commits, appends and partial commits only notify once as many elements
+    // as the data holds changed since the last notification, clients rescanning the data keep up with streams.
+    const DataStatistics& statistics();
+    double dataMinimum() {return statistics().minimum();}
+    double dataMaximum() {return statistics().maximum();}
+    double dataMean() {return statistics().mean();}
+    // Approximate value below which percent (0 to 100) of the data values lie
+    Q_INVOKABLE double percentile(double percent) {return statistics().percentile(percent);}
 
 public slots:
     bool copyFloat64Array1D(const QByteArray& data, int size);
     bool copyFloat64Array2D(const QByteArray& data, int width, int height);
     bool setTestData1D();
     bool setTestData2D();
+    bool copyArray1D(const QByteArray& data, int size, DataType type);
+    bool copyArray2D(const QByteArray& data, int width, int height, DataType type);
     bool setData1D(void* data, int size);
     bool setData2D(void* data, int width, int height);
     bool setData3D(void* data, int width, int height, int depth);
+    bool setData1D(void* data, int size, DataType type);
+    bool setData2D(void* data, int width, int height, DataType type);
+    bool setData3D(void* data, int width, int height, int depth, DataType type);
     void* allocateData1D(int size);
     void* allocateData2D(int width, int height);
     void* allocateData3D(int width, int height, int depth);
+    void* allocateData1D(int size, DataType type);
+    void* allocateData2D(int width, int height, DataType type);
+    void* allocateData3D(int width, int height, int depth, DataType type);
     void* data() const {return m_data;}
     bool commitData();
+    bool commitRegion(int x, int y, int width, int height);
     bool ownsData();
+    void* allocateStream1D(int size);
+    void* allocateStream2D(int width, int height);
+    bool append(const QByteArray& data);
+    // Producer interface, safe to call from a single producer thread other than the GUI thread.
+    // The producer fills the back buffer and publishes it, the GUI thread adopts the latest published
+    // buffer as data. Buffers are never written while in use, renderers can't see partially written data.
+    void* allocateBackBuffer1D(int size, DataType type);
+    void* allocateBackBuffer2D(int width, int height, DataType type);
+    void* allocateBackBuffer3D(int width, int height, int depth, DataType type);
+    void publishBackBuffer();
 
 signals:
     void dataimensionsChanged();
     void dataSizeChanged();
+    void dataTypeChanged(DataType type);
+    void reductionChanged(Reduction reduction);
     void dataChanged();
+    void commitsCoalescedChanged(qint64 count);
+    void streamChanged();
+    void statisticsChanged();
+    void dataReady();
+    void pixelBuffersChanged(int count);
+    void asyncCommitChanged(bool enabled);
+    void framesInFlightChanged(int frames);
 
 protected:
-    bool setData(double* data, const int* dims, int num_dims);
+    bool setData(void* data, const int* dims, int num_dims);
+    void* allocateData(const int* dims, int num_dims);
+    // Set data and shape, or allocate owned data, without committing it
+    bool setShape(void* data, const int* dims, int num_dims);
+    void* allocateBuffer(const int* dims, int num_dims);
+    void scheduleDataChanged();
+    void markDirty(const QRect& rect);
+    void convertFromFloat64(const double* src, int num_elements);
+    void switchDataType(DataType type);
+    void startStream();
+    void* allocateBackBuffer(const int* dims, int num_dims, DataType type);
 
-    double* m_data;
+protected slots:
+    void adoptBackBuffer();
+    void startPreparation();
+    void adoptPrepared();
+    void notifyDataChanged();
+
+protected:
+    void* m_data;
+    // keeps external data alive for preparations still reading it, null if the caller guarantees that
+    std::shared_ptr<const void> m_data_owner;
     int m_num_dims;
     int m_dims[3];
+    DataType m_data_type;
     QByteArray m_data_buffer;
 
 private:
     bool m_new_data;
+    QRegion m_dirty_region;
+    // regions of the last changes, oldest first, for clients which keep their own copies of the data
+    std::deque<QRegion> m_changes;
+    qint64 m_change_count;
+    // generation of the data textures show, older than generation while a commit is prepared
+    qint64 m_shown_generation;
+    bool m_streaming;
+    int m_stream_offset;
+    int m_stream_length;
+    qint64 m_stream_appended;
+    int m_stream_revision;
+    bool m_pyramid_valid;
+    MinMaxPyramid m_pyramid;
+    bool m_statistics_valid;
+    DataStatistics m_statistics;
+    // elements changed since statisticsChanged was emitted
+    qint64 m_statistics_changed;
+    qint64 numElements() const;
+    Reduction m_reduction;
     DataTextureProvider* m_provider;
+    SharedResources m_shared_resources;
+
+    int m_pixel_buffers;
+
+    // asynchronous commits, generation counts commits, prepared data is used if it matches the shown commit
+    struct PreparedData;
+    struct PreparationLink;
+    bool isSelfContained(const PreparedData& prepared) const;
+    bool m_async_commit;
+    int m_frames_in_flight;
+    int m_preparations_running;
+    bool m_preparation_pending;
+    qint64 m_generation;
+    std::shared_ptr<PreparedData> m_prepared;
+    std::shared_ptr<PreparationLink> m_preparation_link;
+    bool m_notify_pending;
+    qint64 m_commits_coalesced;
+
+    // triple buffer of the producer interface, back is owned by the producer, front by the GUI thread
+    struct ProducerBuffer {
+        QByteArray data;
+        int dims[3] = {0, 0, 0};
+        int num_dims = 0;
+        DataType type = Float64;
+    };
+    enum {ProducerIndexMask = 3, ProducerPublished = 4};
+    ProducerBuffer m_producer_buffers[3];
+    int m_producer_back;
+    int m_producer_front;
+    // index of the buffer between producer and GUI thread, flagged if published and not adopted yet
+    std::atomic<int> m_producer_ready;
     friend class DataTexture;
+    friend class PreparationTask;
 };
 
+
+template<typename Visitor>
+void DataSource::visitData(Visitor&& visitor) const
+{
+    visitData(m_data_type, m_data, std::forward<Visitor>(visitor));
+}
+
+template<typename Visitor>
+void DataSource::visitData(DataType type, const void* data, Visitor&& visitor)
+{
+    switch (type) {
+    case Float32:
+        visitor(static_cast<const float*>(data));
+        break;
+    case UInt16:
+        visitor(static_cast<const uint16_t*>(data));
+        break;
+    case Int16:
+        visitor(static_cast<const int16_t*>(data));
+        break;
+    case UInt8:
+        visitor(static_cast<const uint8_t*>(data));
+        break;
+    case Int32:
+        visitor(static_cast<const int32_t*>(data));
+        break;
+    default:
+        visitor(static_cast<const double*>(data));
+        break;
+    }
+}
+
 #endif // DATASOURCE_H
@@ -0,0 +1,157 @@
+#include "datastatistics.h"
+#include "parallelfor.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+
+template<typename T>
+DataStatistics::Summary DataStatistics::summarizeChunk(const T* values, int64_t size, int64_t stride)
+{
+    // independent lanes keep the dependency chains of min, max and sum short
+    constexpr int Lanes = 8;
+    double lane_min[Lanes];
+    double lane_max[Lanes];
+    double lane_sum[Lanes];
+    int64_t lane_count[Lanes];
+    for (int l = 0; l < Lanes; ++l) {
+        lane_min[l] = std::numeric_limits<double>::infinity();
+        lane_max[l] = -std::numeric_limits<double>::infinity();
+        lane_sum[l] = 0.;
+        lane_count[l] = 0;
+    }
+    const int64_t num_blocks = size / Lanes;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+        for (int l = 0; l < Lanes; ++l) {
+            const auto v = static_cast<double>(values[(b*Lanes + l) * stride]);
+            // v - v is zero for finite values only
+            const bool finite = (v - v == 0.);
+            lane_min[l] = (finite && v < lane_min[l]) ? v : lane_min[l];
+            lane_max[l] = (finite && v > lane_max[l]) ? v : lane_max[l];
+            lane_sum[l] += finite ? v : 0.;
+            lane_count[l] += finite ? 1 : 0;
+        }
+    }
+    for (int64_t i = num_blocks * Lanes; i < size; ++i) {
+        const auto v = static_cast<double>(values[i * stride]);
+        if (v - v == 0.) {
+            lane_min[0] = std::min(lane_min[0], v);
+            lane_max[0] = std::max(lane_max[0], v);
+            lane_sum[0] += v;
+            ++lane_count[0];
+        }
+    }
+
+    Summary summary = {lane_min[0], lane_max[0], lane_sum[0], lane_count[0]};
+    for (int l = 1; l < Lanes; ++l) {
+        summary.min = std::min(summary.min, lane_min[l]);
+        summary.max = std::max(summary.max, lane_max[l]);
+        summary.sum += lane_sum[l];
+        summary.count += lane_count[l];
+    }
+    return summary;
+}
+
+template<typename T>
+void DataStatistics::histogramChunk(const T* values, int64_t size, int64_t stride, int64_t* bins) const
+{
+    const double scale = (m_max > m_min) ? NumBins / (m_max - m_min) : 0.;
+    for (int64_t i = 0; i < size; ++i) {
+        const auto v = static_cast<double>(values[i * stride]);
+        if (v - v == 0.) {
+            ++bins[std::min(static_cast<int>((v - m_min) * scale), NumBins - 1)];
+        }
+    }
+}
+
+template<typename T>
+void DataStatistics::build(const T* values, int64_t size, int64_t stride)
+{
+    clear();
+    if (values == nullptr || size <= 0) {
+        return;
+    }
+
+    // chunks are summarized in parallel and merged in order, results do not depend on the number of threads
+    const int64_t num_chunks = (size + ChunkSize - 1) / ChunkSize;
+    std::vector<Summary> summaries(static_cast<size_t>(num_chunks));
+    parallelFor(num_chunks, 1, [&](int64_t first, int64_t last) {
+        for (int64_t c = first; c < last; ++c) {
+            const int64_t begin = c * ChunkSize;
+            summaries[c] = summarizeChunk(values + begin * stride, std::min<int64_t>(ChunkSize, size - begin), stride);
+        }
+    });
+    double sum = 0.;
+    m_min = std::numeric_limits<double>::infinity();
+    m_max = -std::numeric_limits<double>::infinity();
+    for (const Summary& summary : summaries) {
+        m_min = std::min(m_min, summary.min);
+        m_max = std::max(m_max, summary.max);
+        sum += summary.sum;
+        m_count += summary.count;
+    }
+    if (m_count == 0) {
+        clear();
+        return;
+    }
+    m_mean = sum / m_count;
+
+    // second pass for the histogram over the now known range, bins of each thread are added up
+    m_histogram.assign(NumBins, 0);
+    std::mutex histogram_access;
+    parallelFor(num_chunks, 1, [&](int64_t first, int64_t last) {
+        std::vector<int64_t> bins(NumBins, 0);
+        const int64_t begin = first * ChunkSize;
+        histogramChunk(values + begin * stride, std::min(last * ChunkSize, size) - begin, stride, bins.data());
+        std::lock_guard<std::mutex> lock(histogram_access);
+        for (int b = 0; b < NumBins; ++b) {
+            m_histogram[b] += bins[b];
+        }
+    });
+}
+
+void DataStatistics::clear()
+{
+    m_count = 0;
+    m_min = 0.;
+    m_max = 0.;
+    m_mean = 0.;
+    m_histogram.clear();
+}
+
+double DataStatistics::percentile(double percent) const
+{
+    if (m_count == 0) {
+        return 0.;
+    }
+    if (percent <= 0.) {
+        return m_min;
+    }
+    if (percent >= 100.) {
+        return m_max;
+    }
+    const double target = percent * .01 * m_count;
+    const double bin_width = (m_max - m_min) / NumBins;
+    double cumulative = 0.;
+    for (int b = 0; b < NumBins; ++b) {
+        const auto n = static_cast<double>(m_histogram[b]);
+        if (n > 0. && cumulative + n >= target) {
+            return std::min(m_min + (b + (target - cumulative) / n) * bin_width, m_max);
+        }
+        cumulative += n;
+    }
+    return m_max;
+}
+
+
+// Explicitly instantiate statistics for all data source element types in this unit
+#define DATASTATISTICS_INSTANTIATE_TYPE(T) \
+    template void DataStatistics::build<T>(const T*, int64_t, int64_t);
+
+DATASTATISTICS_INSTANTIATE_TYPE(double)
+DATASTATISTICS_INSTANTIATE_TYPE(float)
+DATASTATISTICS_INSTANTIATE_TYPE(uint16_t)
+DATASTATISTICS_INSTANTIATE_TYPE(int16_t)
+DATASTATISTICS_INSTANTIATE_TYPE(uint8_t)
+DATASTATISTICS_INSTANTIATE_TYPE(int32_t)
@@ -0,0 +1,63 @@
+#ifndef DATASTATISTICS_H
+#define DATASTATISTICS_H
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * Minimum, maximum, mean and histogram of data values, non-finite values are ignored.
+ *
+ * Values are summarized in parallel in independent chunks which are merged in order, the histogram spans [minimum, maximum]
+ * with NumBins bins. Percentiles are interpolated linearly within bins and are accurate to one bin width.
+ */
+class DataStatistics
+{
+public:
+    static constexpr int NumBins = 1024;
+    static constexpr int ChunkSize = 1 << 16;
+
+    // Summarize size values which are stride elements apart
+    template<typename T>
+    void build(const T* values, int64_t size, int64_t stride = 1);
+    void clear();
+    bool isEmpty() const {return m_count == 0;}
+
+    int64_t count() const {return m_count;}
+    double minimum() const {return m_min;}
+    double maximum() const {return m_max;}
+    double mean() const {return m_mean;}
+    // Value below which the given percentage (0 to 100) of values lie
+    double percentile(double percent) const;
+
+private:
+    struct Summary {
+        double min;
+        double max;
+        double sum;
+        int64_t count;
+    };
+    template<typename T>
+    static Summary summarizeChunk(const T* values, int64_t size, int64_t stride);
+    template<typename T>
+    void histogramChunk(const T* values, int64_t size, int64_t stride, int64_t* bins) const;
+
+    int64_t m_count = 0;
+    double m_min = 0.;
+    double m_max = 0.;
+    double m_mean = 0.;
+    std::vector<int64_t> m_histogram;
+};
+
+#define DATASTATISTICS_DECLARE_TYPE(T) \
+    extern template void DataStatistics::build<T>(const T*, int64_t, int64_t);
+
+DATASTATISTICS_DECLARE_TYPE(double)
+DATASTATISTICS_DECLARE_TYPE(float)
+DATASTATISTICS_DECLARE_TYPE(uint16_t)
+DATASTATISTICS_DECLARE_TYPE(int16_t)
+DATASTATISTICS_DECLARE_TYPE(uint8_t)
+DATASTATISTICS_DECLARE_TYPE(int32_t)
+
+#undef DATASTATISTICS_DECLARE_TYPE
+
+#endif // DATASTATISTICS_H
@@ -0,0 +1,90 @@
+#include "decimation.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+// Binary search for the first point in [lo, hi) with x >= value, x values are expected in ascending order
+template<typename T>
+static int lowerBoundX(const T* src, int lo, int hi, double value)
+{
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (src[2*mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+template<typename T>
+void decimateMinMax(const T* src, int first, int last, double xmin, double xrange, int num_columns,
+                    const MinMaxPyramid* pyramid, std::vector<double>& dst)
+{
+    if (first >= last || num_columns <= 0 || !(xrange > 0.)) {
+        return;
+    }
+
+    // restrict to visible range, keep one point on each side for segments crossing the view border
+    const int begin = std::max(lowerBoundX(src, first, last, xmin) - 1, first);
+    const int end = std::min(lowerBoundX(src, begin, last, xmin + xrange) + 1, last);
+    const double column_width = xrange / num_columns;
+    dst.reserve(dst.size() + 2 * 4 * static_cast<size_t>(num_columns + 2));
+
+    int i = begin;
+    while (i < end) {
+        // collect all points falling into the current pixel column
+        const double column_end = xmin + (std::floor((src[2*i] - xmin) / column_width) + 1.) * column_width;
+        int idx[4] = {i, i, i, i};
+        if (pyramid != nullptr) {
+            const int next = lowerBoundX(src, i + 1, end, column_end);
+            pyramid->query(src + 1, 2, i, next, idx[1], idx[2]);
+            i = next;
+        } else {
+            for (++i; i < end && src[2*i] < column_end; ++i) {
+                if (src[2*i+1] < src[2*idx[1]+1]) {
+                    idx[1] = i;
+                }
+                if (src[2*i+1] > src[2*idx[2]+1]) {
+                    idx[2] = i;
+                }
+            }
+        }
+        idx[3] = i - 1;
+
+        // emit first, min, max and last point in original order
+        if (idx[1] > idx[2]) {
+            std::swap(idx[1], idx[2]);
+        }
+        for (int k = 0; k < 4; ++k) {
+            if (k == 0 || idx[k] != idx[k-1]) {
+                dst.push_back(src[2*idx[k]+0]);
+                dst.push_back(src[2*idx[k]+1]);
+            }
+        }
+    }
+}
+
+template<typename T>
+void decimateMinMaxRing(const T* src, int capacity, int start, int length, double xmin, double xrange, int num_columns,
+                        const MinMaxPyramid* pyramid, std::vector<double>& dst)
+{
+    const int first_end = std::min(start + length, capacity);
+    decimateMinMax(src, start, first_end, xmin, xrange, num_columns, pyramid, dst);
+    decimateMinMax(src, 0, length - (first_end - start), xmin, xrange, num_columns, pyramid, dst);
+}
+
+
+// Explicitly instantiate decimation functions for all data source element types in this unit
+#define DECIMATION_INSTANTIATE_TYPE(T) \
+    template void decimateMinMax<T>(const T*, int, int, double, double, int, const MinMaxPyramid*, std::vector<double>&); \
+    template void decimateMinMaxRing<T>(const T*, int, int, int, double, double, int, const MinMaxPyramid*, std::vector<double>&);
+
+DECIMATION_INSTANTIATE_TYPE(double)
+DECIMATION_INSTANTIATE_TYPE(float)
+DECIMATION_INSTANTIATE_TYPE(uint16_t)
+DECIMATION_INSTANTIATE_TYPE(int16_t)
+DECIMATION_INSTANTIATE_TYPE(uint8_t)
+DECIMATION_INSTANTIATE_TYPE(int32_t)
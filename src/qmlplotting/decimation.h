@@ -0,0 +1,39 @@
+#ifndef DECIMATION_H
+#define DECIMATION_H
+
+#include <vector>
+#include <cstdint>
+#include "minmaxpyramid.h"
+
+/**
+ * Min/max decimation of interleaved xy data to pixel columns.
+ *
+ * Each pixel column of the visible x-range is reduced to its first, minimum, maximum and last point, drawn as line strip
+ * the result covers exactly the same pixels as the full data set. X values are expected in ascending order, otherwise
+ * the output is still a subsequence of the input but columns are no longer complete.
+ * With a min/max pyramid of the y values, each column costs O(log(num_points)) instead of a full scan.
+ */
+
+// Points in range [first, last) are decimated and appended to dst
+template<typename T>
+void decimateMinMax(const T* src, int first, int last, double xmin, double xrange, int num_columns,
+                    const MinMaxPyramid* pyramid, std::vector<double>& dst);
+// Ring buffer of capacity points with length points starting at start, consists of two sorted parts, oldest points first
+template<typename T>
+void decimateMinMaxRing(const T* src, int capacity, int start, int length, double xmin, double xrange, int num_columns,
+                        const MinMaxPyramid* pyramid, std::vector<double>& dst);
+
+#define DECIMATION_DECLARE_TYPE(T) \
+    extern template void decimateMinMax<T>(const T*, int, int, double, double, int, const MinMaxPyramid*, std::vector<double>&); \
+    extern template void decimateMinMaxRing<T>(const T*, int, int, int, double, double, int, const MinMaxPyramid*, std::vector<double>&);
+
+DECIMATION_DECLARE_TYPE(double)
+DECIMATION_DECLARE_TYPE(float)
+DECIMATION_DECLARE_TYPE(uint16_t)
+DECIMATION_DECLARE_TYPE(int16_t)
+DECIMATION_DECLARE_TYPE(uint8_t)
+DECIMATION_DECLARE_TYPE(int32_t)
+
+#undef DECIMATION_DECLARE_TYPE
+
+#endif // DECIMATION_H
@@ -0,0 +1,192 @@
+#include "imagepyramid.h"
+#include "parallelfor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+
+// Round and saturate reduced values for integer levels
+template<typename T>
+static T toLevelValue(double value)
+{
+    if (std::is_integral<T>::value) {
+        return static_cast<T>(std::min(std::max(std::round(value), double(std::numeric_limits<T>::lowest())),
+                                       double(std::numeric_limits<T>::max())));
+    }
+    return static_cast<T>(value);
+}
+
+template<typename T>
+static T reduce(double v0, double v1, double v2, double v3, ImageReduction mode)
+{
+    switch (mode) {
+    case ImageReduction::Max:
+        return toLevelValue<T>(std::max(std::max(v0, v1), std::max(v2, v3)));
+    case ImageReduction::Min:
+        return toLevelValue<T>(std::min(std::min(v0, v1), std::min(v2, v3)));
+    case ImageReduction::Peak: {
+        const auto peak = [](double a, double b) {return (std::abs(b) > std::abs(a)) ? b : a;};
+        return toLevelValue<T>(peak(peak(v0, v1), peak(v2, v3)));
+    }
+    default:
+        return toLevelValue<T>(.25 * (v0 + v1 + v2 + v3));
+    }
+}
+
+// Reduce the pixels [xb, xe) x [yb, ye) of src, used for the 3 pixel wide blocks at the edges of odd sizes
+template<typename S, typename T>
+static T reduceBlock(const S* src, int width, int xb, int xe, int yb, int ye, ImageReduction mode)
+{
+    double value = src[static_cast<size_t>(yb) * width + xb];
+    double sum = 0.;
+    for (int y = yb; y < ye; ++y) {
+        const S* row = src + static_cast<size_t>(y) * width;
+        for (int x = xb; x < xe; ++x) {
+            const double v = row[x];
+            sum += v;
+            switch (mode) {
+            case ImageReduction::Max:
+                value = std::max(value, v);
+                break;
+            case ImageReduction::Min:
+                value = std::min(value, v);
+                break;
+            case ImageReduction::Peak:
+                value = (std::abs(v) > std::abs(value)) ? v : value;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    if (mode == ImageReduction::Mean) {
+        value = sum / (static_cast<double>(xe - xb) * (ye - yb));
+    }
+    return toLevelValue<T>(value);
+}
+
+// Reduce 2x2 blocks of src into the pixels [x0, x1) x [y0, y1) of dst, the last row/column of odd sizes is folded
+// into the last block, sizes of 1 are kept
+template<typename S, typename T>
+static void reduceBlocks(const S* src, int width, int height, ImageReduction mode, T* dst, int x0, int y0, int x1, int y1)
+{
+    const int dst_width = std::max(width / 2, 1);
+    const int dst_height = std::max(height / 2, 1);
+    // rows are reduced in parallel, a chunk covers about ParallelGrainSize output pixels
+    parallelFor(y1 - y0, std::max<int64_t>(ParallelGrainSize / (x1 - x0), 1), [=](int64_t begin, int64_t end) {
+        for (auto y = static_cast<int>(begin) + y0; y < end + y0; ++y) {
+            const int ye = (y == dst_height - 1) ? height : 2*y + 2;
+            const S* row0 = src + static_cast<size_t>(2*y) * width;
+            const S* row1 = src + static_cast<size_t>(std::min(2*y + 1, height - 1)) * width;
+            T* out = dst + static_cast<size_t>(y) * dst_width;
+            for (int x = x0; x < x1; ++x) {
+                const int xe = (x == dst_width - 1) ? width : 2*x + 2;
+                if (xe - 2*x == 3 || ye - 2*y == 3) {
+                    out[x] = reduceBlock<S, T>(src, width, 2*x, xe, 2*y, ye, mode);
+                } else {
+                    const int xs1 = std::min(2*x + 1, width - 1);
+                    out[x] = reduce<T>(row0[2*x], row0[xs1], row1[2*x], row1[xs1], mode);
+                }
+            }
+        }
+    });
+}
+
+template<typename S, typename T>
+static void reduceLevel(const S* src, int width, int height, ImageReduction mode, T* dst)
+{
+    reduceBlocks(src, width, height, mode, dst, 0, 0, std::max(width / 2, 1), std::max(height / 2, 1));
+}
+
+// Pixels of the reduced level depending on pixels [first, last] of a level of the given size, empty if none
+// (the last pixel of odd sizes belongs to the last block)
+static bool reducedRange(int size, int* first, int* last)
+{
+    const int reduced_size = std::max(size / 2, 1);
+    *first = std::min(*first / 2, reduced_size - 1);
+    *last = std::min(*last / 2, reduced_size - 1);
+    return *first <= *last;
+}
+
+template<typename S, typename T>
+int buildImagePyramid(const S* src, int width, int height, ImageReduction mode, std::vector<T>& levels)
+{
+    levels.clear();
+    if (mode == ImageReduction::None || (width < 2 && height < 2)) {
+        return 0;
+    }
+
+    // size all levels first, pointers into levels stay valid while reducing
+    size_t num_elements = 0;
+    int num_levels = 0;
+    for (int w = width, h = height; w > 1 || h > 1; ++num_levels) {
+        w = std::max(w / 2, 1);
+        h = std::max(h / 2, 1);
+        num_elements += static_cast<size_t>(w) * h;
+    }
+    levels.resize(num_elements);
+
+    T* dst = levels.data();
+    reduceLevel(src, width, height, mode, dst);
+    for (int level = 1; level < num_levels; ++level) {
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+        T* next = dst + static_cast<size_t>(width) * height;
+        reduceLevel(dst, width, height, mode, next);
+        dst = next;
+    }
+    return num_levels;
+}
+
+template<typename S, typename T>
+int updateImagePyramid(const S* src, int width, int height, ImageReduction mode, const ImageRegion& region,
+                       T* levels, std::vector<ImageRegion>& changed)
+{
+    changed.clear();
+    if (mode == ImageReduction::None || (width < 2 && height < 2)) {
+        return 0;
+    }
+
+    // inclusive pixel range of the changed region in the current level
+    int x0 = std::max(region.x, 0);
+    int y0 = std::max(region.y, 0);
+    int x1 = std::min(region.x + region.width, width) - 1;
+    int y1 = std::min(region.y + region.height, height) - 1;
+    bool dirty = x0 <= x1 && y0 <= y1;
+
+    T* dst = levels;
+    const T* prev = nullptr;
+    while (width > 1 || height > 1) {
+        dirty = dirty && reducedRange(width, &x0, &x1) && reducedRange(height, &y0, &y1);
+        if (dirty) {
+            if (prev == nullptr) {
+                reduceBlocks(src, width, height, mode, dst, x0, y0, x1 + 1, y1 + 1);
+            } else {
+                reduceBlocks(prev, width, height, mode, dst, x0, y0, x1 + 1, y1 + 1);
+            }
+            changed.push_back({x0, y0, x1 - x0 + 1, y1 - y0 + 1});
+        } else {
+            changed.push_back(ImageRegion());
+        }
+        prev = dst;
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+        dst += static_cast<size_t>(width) * height;
+    }
+    return static_cast<int>(changed.size());
+}
+
+
+// Explicitly instantiate pyramid builders for all data source element types in this unit
+#define IMAGEPYRAMID_INSTANTIATE_TYPE(S, T) \
+    template int buildImagePyramid<S, T>(const S*, int, int, ImageReduction, std::vector<T>&); \
+    template int updateImagePyramid<S, T>(const S*, int, int, ImageReduction, const ImageRegion&, T*, std::vector<ImageRegion>&);
+
+IMAGEPYRAMID_INSTANTIATE_TYPE(double, float)
+IMAGEPYRAMID_INSTANTIATE_TYPE(float, float)
+IMAGEPYRAMID_INSTANTIATE_TYPE(uint16_t, uint16_t)
+IMAGEPYRAMID_INSTANTIATE_TYPE(int16_t, int16_t)
+IMAGEPYRAMID_INSTANTIATE_TYPE(uint8_t, uint8_t)
+IMAGEPYRAMID_INSTANTIATE_TYPE(int32_t, int32_t)
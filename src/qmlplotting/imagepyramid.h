@@ -0,0 +1,56 @@
+#ifndef IMAGEPYRAMID_H
+#define IMAGEPYRAMID_H
+
+#include <vector>
+#include <cstdint>
+
+// Reduction of 2x2 pixel blocks between pyramid levels, in the order of DataSource::Reduction
+enum class ImageReduction {
+    None,
+    Mean,   // average, smooth but thins out isolated peaks
+    Max,
+    Min,
+    Peak    // value farthest from zero, keeps sparse positive and negative peaks
+};
+
+// Pixel rectangle of one image level
+struct ImageRegion {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * Build reduced levels 1..n of a single component 2D image down to 1x1, following the OpenGL mipmap sizes
+ * (each level is half the size of the previous one, rounded down, the last row/column of odd sizes is reduced into
+ * the last block of 3 pixels, so no peak is lost). Levels are packed consecutively into
+ * levels, the first level is reduced from src, values are converted to the element type T of the levels.
+ * Returns the number of levels.
+ */
+template<typename S, typename T>
+int buildImagePyramid(const S* src, int width, int height, ImageReduction mode, std::vector<T>& levels);
+
+/**
+ * Update levels built by buildImagePyramid of the same size and mode after the pixels in region of src changed.
+ * Only the blocks depending on region are reduced again, changed receives their rectangle in each level 1..n
+ * (empty if no pixel of a level depends on region). Returns the number of levels.
+ */
+template<typename S, typename T>
+int updateImagePyramid(const S* src, int width, int height, ImageReduction mode, const ImageRegion& region,
+                       T* levels, std::vector<ImageRegion>& changed);
+
+#define IMAGEPYRAMID_DECLARE_TYPE(S, T) \
+    extern template int buildImagePyramid<S, T>(const S*, int, int, ImageReduction, std::vector<T>&); \
+    extern template int updateImagePyramid<S, T>(const S*, int, int, ImageReduction, const ImageRegion&, T*, std::vector<ImageRegion>&);
+
+IMAGEPYRAMID_DECLARE_TYPE(double, float)
+IMAGEPYRAMID_DECLARE_TYPE(float, float)
+IMAGEPYRAMID_DECLARE_TYPE(uint16_t, uint16_t)
+IMAGEPYRAMID_DECLARE_TYPE(int16_t, int16_t)
+IMAGEPYRAMID_DECLARE_TYPE(uint8_t, uint8_t)
+IMAGEPYRAMID_DECLARE_TYPE(int32_t, int32_t)
+
+#undef IMAGEPYRAMID_DECLARE_TYPE
+
+#endif // IMAGEPYRAMID_H
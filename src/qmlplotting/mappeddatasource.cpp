@@ -0,0 +1,92 @@
+#include "mappeddatasource.h"
+
+
+MappedDataSource::MappedDataSource(QQuickItem* parent)
+    : DataSource(parent)
+{
+    // a new element type changes the mapped size
+    connect(this, &DataSource::dataTypeChanged, this, &MappedDataSource::remap);
+}
+
+void MappedDataSource::setFileName(const QString& fileName)
+{
+    if (m_file_name != fileName) {
+        m_file_name = fileName;
+        emit fileNameChanged(m_file_name);
+        remap();
+    }
+}
+
+void MappedDataSource::setFileOffset(qint64 fileOffset)
+{
+    if (m_file_offset != fileOffset) {
+        m_file_offset = fileOffset;
+        emit fileOffsetChanged(m_file_offset);
+        remap();
+    }
+}
+
+void MappedDataSource::setShape(const QList<int>& shape)
+{
+    if (m_shape != shape) {
+        m_shape = shape;
+        emit shapeChanged(m_shape);
+        remap();
+    }
+}
+
+void MappedDataSource::componentComplete()
+{
+    DataSource::componentComplete();
+    remap();
+}
+
+void MappedDataSource::remap()
+{
+    // wait until all properties are set
+    if (!isComponentComplete()) {
+        return;
+    }
+
+    std::shared_ptr<QFile> file;
+    uchar* data = nullptr;
+    int dims[3] = {0, 0, 0};
+    const int num_dims = m_shape.size();
+    if (!m_file_name.isEmpty() && num_dims > 0 && num_dims <= 3) {
+        qint64 num_bytes = elementSize();
+        for (int i = 0; i < num_dims; ++i) {
+            dims[i] = m_shape[i];
+            num_bytes *= qMax(dims[i], 0);
+        }
+        // the last owner may be a preparation on a worker thread, the file is deleted on the GUI thread
+        file.reset(new QFile(m_file_name), [](QFile* f) { f->deleteLater(); });
+        if (num_bytes <= 0 || m_file_offset < 0 || !file->open(QIODevice::ReadOnly)) {
+            qWarning("MappedDataSource: can not open %s", qPrintable(m_file_name));
+        } else if (file->size() < m_file_offset + num_bytes) {
+            qWarning("MappedDataSource: %s is smaller than offset and shape", qPrintable(m_file_name));
+        } else {
+            data = file->map(m_file_offset, num_bytes);
+            if (data == nullptr) {
+                qWarning("MappedDataSource: can not map %s", qPrintable(m_file_name));
+            }
+        }
+    }
+
+    // the renderer only reads data during sync, preparations of asynchronous commits keep the old file mapped
+    // until they finish
+    const bool was_mapped = mapped();
+    if (data != nullptr) {
+        // mapping is read only, data of a mapped source is never written
+        setShape(data, dims, num_dims);
+        m_file = std::move(file);
+    } else {
+        int size = 0;
+        allocateBuffer(&size, 1);
+        m_file.reset();
+    }
+    m_data_owner = m_file;
+    commitData();
+    if (was_mapped != mapped()) {
+        emit mappedChanged(mapped());
+    }
+}
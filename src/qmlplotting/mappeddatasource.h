@@ -0,0 +1,49 @@
+#ifndef MAPPEDDATASOURCE_H
+#define MAPPEDDATASOURCE_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <memory>
+#include "datasource.h"
+
+
+// Data source serving a raw binary file through a read-only memory mapping, pages are loaded on access
+class MappedDataSource : public DataSource
+{
+    Q_OBJECT
+    Q_PROPERTY(QString fileName MEMBER m_file_name WRITE setFileName NOTIFY fileNameChanged)
+    Q_PROPERTY(qint64 fileOffset MEMBER m_file_offset WRITE setFileOffset NOTIFY fileOffsetChanged)
+    Q_PROPERTY(QList<int> shape MEMBER m_shape WRITE setShape NOTIFY shapeChanged)
+    Q_PROPERTY(bool mapped READ mapped NOTIFY mappedChanged)
+
+public:
+    explicit MappedDataSource(QQuickItem* parent = nullptr);
+
+    bool mapped() const {return m_file != nullptr;}
+
+signals:
+    void fileNameChanged(const QString& fileName);
+    void fileOffsetChanged(qint64 fileOffset);
+    void shapeChanged(const QList<int>& shape);
+    void mappedChanged(bool mapped);
+
+public slots:
+    void setFileName(const QString& fileName);
+    void setFileOffset(qint64 fileOffset);
+    void setShape(const QList<int>& shape);
+
+protected:
+    void componentComplete() override;
+
+private:
+    void remap();
+
+    QString m_file_name;
+    qint64 m_file_offset = 0;
+    QList<int> m_shape;
+    // shared with running preparations, see DataSource::m_data_owner
+    std::shared_ptr<QFile> m_file;
+};
+
+#endif // MAPPEDDATASOURCE_H
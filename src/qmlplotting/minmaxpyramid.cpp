@@ -0,0 +1,141 @@
+#include "minmaxpyramid.h"
+
+#include <algorithm>
+
+
+template<typename T>
+MinMaxPyramid::Entry MinMaxPyramid::summarizeBlock(const T* values, int stride, int block) const
+{
+    int imin = block * BlockSize;
+    int imax = imin;
+    for (int i = imin + 1; i < (block + 1) * BlockSize; ++i) {
+        const T v = values[i*stride];
+        if (v < values[imin*stride]) {
+            imin = i;
+        }
+        if (v > values[imax*stride]) {
+            imax = i;
+        }
+    }
+    return {imin, imax};
+}
+
+template<typename T>
+MinMaxPyramid::Entry MinMaxPyramid::combineBlocks(const T* values, int stride, const Entry& e0, const Entry& e1) const
+{
+    return {
+        (values[e1.index_min*stride] < values[e0.index_min*stride]) ? e1.index_min : e0.index_min,
+        (values[e1.index_max*stride] > values[e0.index_max*stride]) ? e1.index_max : e0.index_max
+    };
+}
+
+template<typename T>
+void MinMaxPyramid::build(const T* values, int stride, int size)
+{
+    clear();
+    if (size < 2 * BlockSize) {
+        return;
+    }
+    m_size = size;
+
+    // level 0 from raw data, only complete blocks are summarized
+    std::vector<Entry> level(static_cast<size_t>(size / BlockSize));
+    for (size_t b = 0; b < level.size(); ++b) {
+        level[b] = summarizeBlock(values, stride, static_cast<int>(b));
+    }
+    m_levels.push_back(std::move(level));
+
+    // combine pairs of blocks until a single block remains
+    while (m_levels.back().size() >= 2) {
+        const std::vector<Entry>& below = m_levels.back();
+        std::vector<Entry> above(below.size() / 2);
+        for (size_t b = 0; b < above.size(); ++b) {
+            above[b] = combineBlocks(values, stride, below[2*b], below[2*b+1]);
+        }
+        m_levels.push_back(std::move(above));
+    }
+}
+
+template<typename T>
+void MinMaxPyramid::update(const T* values, int stride, int begin, int end)
+{
+    begin = std::max(begin, 0);
+    end = std::min(end, m_size);
+    if (m_levels.empty() || begin >= end) {
+        return;
+    }
+
+    // recompute affected blocks of level 0, then their parents on all higher levels
+    size_t first = static_cast<size_t>(begin / BlockSize);
+    size_t last = static_cast<size_t>((end - 1) / BlockSize);
+    for (size_t b = first; b <= last && b < m_levels[0].size(); ++b) {
+        m_levels[0][b] = summarizeBlock(values, stride, static_cast<int>(b));
+    }
+    for (size_t l = 1; l < m_levels.size(); ++l) {
+        first /= 2;
+        last /= 2;
+        const std::vector<Entry>& below = m_levels[l-1];
+        std::vector<Entry>& level = m_levels[l];
+        for (size_t b = first; b <= last && b < level.size(); ++b) {
+            level[b] = combineBlocks(values, stride, below[2*b], below[2*b+1]);
+        }
+    }
+}
+
+void MinMaxPyramid::clear()
+{
+    m_levels.clear();
+    m_size = 0;
+}
+
+template<typename T>
+void MinMaxPyramid::query(const T* values, int stride, int begin, int end, int& index_min, int& index_max) const
+{
+    index_min = begin;
+    index_max = begin;
+    const auto num_levels = static_cast<int>(m_levels.size());
+    int i = begin;
+    while (i < end) {
+        if (num_levels > 0 && i % BlockSize == 0 && i + BlockSize <= end) {
+            // use the largest aligned block that fits into the remaining range
+            int l = 0;
+            while (l + 1 < num_levels && i % (BlockSize << (l+1)) == 0 && static_cast<long long>(i) + (BlockSize << (l+1)) <= end) {
+                ++l;
+            }
+            const size_t block = static_cast<size_t>(i / (BlockSize << l));
+            if (block < m_levels[static_cast<size_t>(l)].size()) {
+                const Entry& e = m_levels[static_cast<size_t>(l)][block];
+                if (values[e.index_min*stride] < values[index_min*stride]) {
+                    index_min = e.index_min;
+                }
+                if (values[e.index_max*stride] > values[index_max*stride]) {
+                    index_max = e.index_max;
+                }
+                i += BlockSize << l;
+                continue;
+            }
+        }
+        // fall back to raw samples at unaligned range borders
+        if (values[i*stride] < values[index_min*stride]) {
+            index_min = i;
+        }
+        if (values[i*stride] > values[index_max*stride]) {
+            index_max = i;
+        }
+        ++i;
+    }
+}
+
+
+// Explicitly instantiate pyramid functions for all data source element types in this unit
+#define MINMAXPYRAMID_INSTANTIATE_TYPE(T) \
+    template void MinMaxPyramid::build<T>(const T*, int, int); \
+    template void MinMaxPyramid::query<T>(const T*, int, int, int, int&, int&) const; \
+    template void MinMaxPyramid::update<T>(const T*, int, int, int);
+
+MINMAXPYRAMID_INSTANTIATE_TYPE(double)
+MINMAXPYRAMID_INSTANTIATE_TYPE(float)
+MINMAXPYRAMID_INSTANTIATE_TYPE(uint16_t)
+MINMAXPYRAMID_INSTANTIATE_TYPE(int16_t)
+MINMAXPYRAMID_INSTANTIATE_TYPE(uint8_t)
+MINMAXPYRAMID_INSTANTIATE_TYPE(int32_t)
@@ -0,0 +1,59 @@
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * Multi-resolution index of minimum and maximum positions for strided data.
+ *
+ * Level 0 summarizes blocks of BlockSize samples, every further level combines two blocks of the level below.
+ * The pyramid stores sample indices only, queries therefore require the same data the pyramid was built from.
+ */
+class MinMaxPyramid
+{
+public:
+    static constexpr int BlockSize = 64;
+
+    template<typename T>
+    void build(const T* values, int stride, int size);
+    // Update summaries after values in range [begin, end) changed
+    template<typename T>
+    void update(const T* values, int stride, int begin, int end);
+    void clear();
+    bool isEmpty() const {return m_levels.empty();}
+    int size() const {return m_size;}
+
+    // Find indices of minimum and maximum value in range [begin, end) in O(BlockSize + log(size))
+    template<typename T>
+    void query(const T* values, int stride, int begin, int end, int& index_min, int& index_max) const;
+
+private:
+    struct Entry {
+        int index_min;
+        int index_max;
+    };
+    template<typename T>
+    Entry summarizeBlock(const T* values, int stride, int block) const;
+    template<typename T>
+    Entry combineBlocks(const T* values, int stride, const Entry& e0, const Entry& e1) const;
+
+    std::vector<std::vector<Entry>> m_levels;
+    int m_size = 0;
+};
+
+#define MINMAXPYRAMID_DECLARE_TYPE(T) \
+    extern template void MinMaxPyramid::build<T>(const T*, int, int); \
+    extern template void MinMaxPyramid::query<T>(const T*, int, int, int, int&, int&) const; \
+    extern template void MinMaxPyramid::update<T>(const T*, int, int, int);
+
+MINMAXPYRAMID_DECLARE_TYPE(double)
+MINMAXPYRAMID_DECLARE_TYPE(float)
+MINMAXPYRAMID_DECLARE_TYPE(uint16_t)
+MINMAXPYRAMID_DECLARE_TYPE(int16_t)
+MINMAXPYRAMID_DECLARE_TYPE(uint8_t)
+MINMAXPYRAMID_DECLARE_TYPE(int32_t)
+
+#undef MINMAXPYRAMID_DECLARE_TYPE
+
+#endif // MINMAXPYRAMID_H
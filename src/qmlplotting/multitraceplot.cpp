@@ -0,0 +1,370 @@
+#include "multitraceplot.h"
+
+#include <QSGGeometryNode>
+#include <QSGMaterialShader>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <algorithm>
+#include "qsgdatatexture.h"
+#include "renderstats.h"
+
+#define GLSL(ver, src) "#version " #ver "\n" #src
+
+class MultiTraceMaterial : public QSGMaterial
+{
+public:
+    explicit MultiTraceMaterial(bool one_dim) : m_one_dim(one_dim) {
+        setFlag(QSGMaterial::Blending);
+    }
+    QSGMaterialType *type() const override {
+        // 1D data is fetched from a 1D texture by a different shader
+        static QSGMaterialType type[2];
+        return &type[m_one_dim ? 1 : 0];
+    }
+    QSGMaterialShader *createShader() const override;
+    const bool m_one_dim;
+    QSGTexture* m_texture_data = nullptr;
+    // ring buffer data starts at point (1D) or trace (2D) m_shift
+    int m_shift = 0;
+    // trace table, row 0 holds the colours, row 1 the offsets
+    QSGDataTexture<float> m_texture_traces;
+    QSizeF m_size;
+    QSizeF m_scale;
+    QPointF m_offset;
+    double m_value_scale = 1.;
+    // layout of the current geometry
+    int m_num_samples = 0;
+    int m_num_traces = 0;
+};
+
+class MultiTraceShader : public QSGMaterialShader
+{
+public:
+    explicit MultiTraceShader(bool one_dim) : m_one_dim(one_dim) {}
+
+    const char *vertexShader() const override {
+        // vertex holds sample and trace index, the single trace of 1D data holds the y values of its xy points
+        if (m_one_dim) {
+            return GLSL(130,
+                in highp vec2 vertex;
+                uniform sampler1D data;
+                uniform sampler2D traces;
+                uniform highp mat4 matrix;
+                uniform highp vec2 size;
+                uniform highp vec2 scale;
+                uniform highp vec2 offset;
+                uniform highp float valuescale;
+                uniform int shift;
+                out lowp vec4 color;
+
+                void main() {
+                    ivec2 t = ivec2(vertex);
+                    int i = (t.x + shift) % (textureSize(data, 0) / 2);
+                    highp float val = texelFetch(data, 2 * i + 1, 0).r / valuescale;
+                    color = texelFetch(traces, ivec2(0, 0), 0);
+                    val += texelFetch(traces, ivec2(0, 1), 0).r;
+                    highp vec2 p = (vec2(vertex.x, val) - offset) * scale * size;
+                    gl_Position = matrix * vec4(p.x, size.y - p.y, 0., 1.);
+                }
+            );
+        }
+        return GLSL(130,
+            in highp vec2 vertex;
+            uniform sampler2D data;
+            uniform sampler2D traces;
+            uniform highp mat4 matrix;
+            uniform highp vec2 size;
+            uniform highp vec2 scale;
+            uniform highp vec2 offset;
+            uniform highp float valuescale;
+            uniform int shift;
+            out lowp vec4 color;
+
+            void main() {
+                ivec2 t = ivec2(vertex);
+                highp float val = texelFetch(data, ivec2(t.x, (t.y + shift) % textureSize(data, 0).y), 0).r / valuescale;
+                color = texelFetch(traces, ivec2(t.y, 0), 0);
+                val += texelFetch(traces, ivec2(t.y, 1), 0).r;
+                highp vec2 p = (vec2(vertex.x, val) - offset) * scale * size;
+                gl_Position = matrix * vec4(p.x, size.y - p.y, 0., 1.);
+            }
+        );
+    }
+
+    const char *fragmentShader() const override {
+        return GLSL(130,
+            uniform lowp float opacity;
+            in lowp vec4 color;
+            out vec4 fragColor;
+
+            void main() {
+                lowp float o = opacity * color.a;
+                fragColor.rgb = color.rgb * o;
+                fragColor.a = o;
+            }
+        );
+    }
+
+    char const *const *attributeNames() const override {
+        static char const *const names[] = { "vertex", nullptr };
+        return names;
+    }
+
+    void initialize() override {
+        QSGMaterialShader::initialize();
+        m_id_matrix = program()->uniformLocation("matrix");
+        m_id_opacity = program()->uniformLocation("opacity");
+        m_id_data = program()->uniformLocation("data");
+        m_id_traces = program()->uniformLocation("traces");
+        m_id_size = program()->uniformLocation("size");
+        m_id_scale = program()->uniformLocation("scale");
+        m_id_offset = program()->uniformLocation("offset");
+        m_id_value_scale = program()->uniformLocation("valuescale");
+        m_id_shift = program()->uniformLocation("shift");
+    }
+
+    void updateState(const RenderState& state, QSGMaterial* newMaterial, QSGMaterial*) override {
+        Q_ASSERT(program()->isLinked());
+        auto* material = static_cast<MultiTraceMaterial*>(newMaterial);
+        QOpenGLFunctions* functions = state.context()->functions();
+
+        if (state.isMatrixDirty()) {
+            program()->setUniformValue(m_id_matrix, state.combinedMatrix());
+        }
+        if (state.isOpacityDirty()) {
+            program()->setUniformValue(m_id_opacity, state.opacity());
+        }
+
+        // bind material parameters
+        program()->setUniformValue(m_id_size, material->m_size);
+        program()->setUniformValue(m_id_scale, material->m_scale);
+        program()->setUniformValue(m_id_offset, material->m_offset);
+        program()->setUniformValue(m_id_value_scale, float(material->m_value_scale));
+        program()->setUniformValue(m_id_shift, material->m_shift);
+
+        // bind the trace table to unit 1 and the data texture to unit 0
+        functions->glActiveTexture(GL_TEXTURE1);
+        program()->setUniformValue(m_id_traces, 1);
+        material->m_texture_traces.bind();
+        functions->glActiveTexture(GL_TEXTURE0);
+        program()->setUniformValue(m_id_data, 0);
+        material->m_texture_data->bind();
+    }
+
+private:
+    int m_id_matrix;
+    int m_id_opacity;
+    int m_id_data;
+    int m_id_traces;
+    int m_id_size;
+    int m_id_scale;
+    int m_id_offset;
+    int m_id_value_scale;
+    int m_id_shift;
+    const bool m_one_dim;
+};
+
+inline QSGMaterialShader* MultiTraceMaterial::createShader() const { return new MultiTraceShader(m_one_dim); }
+
+// ----------------------------------------------------------------------------
+
+
+MultiTracePlot::MultiTracePlot(QQuickItem* parent) : DataClient(parent)
+{
+    setFlag(QQuickItem::ItemHasContents);
+    setClip(true);
+}
+
+MultiTracePlot::~MultiTracePlot() = default;
+
+void MultiTracePlot::setViewRect(const QRectF& viewrect)
+{
+    if (viewrect != m_view_rect) {
+        m_view_rect = viewrect;
+        emit viewRectChanged(m_view_rect);
+        update();
+    }
+}
+
+void MultiTracePlot::setLineWidth(double width)
+{
+    if (m_linewidth != width) {
+        m_linewidth = width;
+        emit lineWidthChanged(m_linewidth);
+        update();
+    }
+}
+
+void MultiTracePlot::setTraceColors(const QVariantList& colors)
+{
+    if (m_trace_colors != colors) {
+        m_trace_colors = colors;
+        m_new_traces = true;
+        emit traceColorsChanged(m_trace_colors);
+        update();
+    }
+}
+
+void MultiTracePlot::setTraceSpacing(double spacing)
+{
+    if (m_trace_spacing != spacing) {
+        m_trace_spacing = spacing;
+        m_new_traces = true;
+        emit traceSpacingChanged(m_trace_spacing);
+        update();
+    }
+}
+
+void MultiTracePlot::setTraceOffsets(const QVariantList& offsets)
+{
+    if (m_trace_offsets != offsets) {
+        m_trace_offsets = offsets;
+        m_new_traces = true;
+        emit traceOffsetsChanged(m_trace_offsets);
+        update();
+    }
+}
+
+// Line segments between neighbouring samples of every trace, vertices are (sample, trace) pairs
+static void updateTraceGeometry(QSGGeometry* geometry, int num_samples, int num_traces)
+{
+    QMLPLOTTING_TRACE_SCOPE("MultiTracePlot::updateTraceGeometry");
+    const int num_segments = std::max(num_samples - 1, 0);
+    geometry->allocate(num_samples * num_traces, 2 * num_segments * num_traces);
+    auto* vertices = static_cast<float*>(geometry->vertexData());
+    quint32* indices = geometry->indexDataAsUInt();
+    for (int j = 0; j < num_traces; ++j) {
+        for (int i = 0; i < num_samples; ++i) {
+            *vertices++ = static_cast<float>(i);
+            *vertices++ = static_cast<float>(j);
+        }
+        const auto first = static_cast<quint32>(j * num_samples);
+        for (int i = 0; i < num_segments; ++i) {
+            *indices++ = first + i;
+            *indices++ = first + i + 1;
+        }
+    }
+    RenderStats::addVertices(geometry->vertexCount());
+}
+
+static void updateTraceTable(QSGDataTexture<float>& texture, int num_traces,
+                             const QVariantList& colors, double spacing, const QVariantList& offsets)
+{
+    const int width = std::max(num_traces, 1);
+    float* dst = texture.allocateData2D(width, 2, 4);
+    for (int i = 0; i < width; ++i) {
+        const QColor color = colors.isEmpty() ? QColor(Qt::black) : colors[i % colors.size()].value<QColor>();
+        dst[4*i+0] = static_cast<float>(color.redF());
+        dst[4*i+1] = static_cast<float>(color.greenF());
+        dst[4*i+2] = static_cast<float>(color.blueF());
+        dst[4*i+3] = static_cast<float>(color.alphaF());
+        float* offset = dst + 4*(width + i);
+        offset[0] = static_cast<float>(i < offsets.size() ? offsets[i].toDouble() : i * spacing);
+        offset[1] = offset[2] = offset[3] = 0.f;
+    }
+    texture.commitData();
+}
+
+QSGNode* MultiTracePlot::updatePaintNode(QSGNode* n, QQuickItem::UpdatePaintNodeData*)
+{
+    PaintScope paint_scope(m_render_stats, this);
+    QSGGeometryNode* n_geom;
+    QSGGeometry* geometry;
+    MultiTraceMaterial* material;
+
+    if (n == nullptr) {
+        n = new QSGNode;
+    }
+
+    // 1D and 2D data need different shaders, 3D data is not drawn
+    const int num_dims = (m_source != nullptr) ? m_source->dataDimensions() : 0;
+    const bool one_dim = num_dims == 1;
+    const bool supported = num_dims == 1 || num_dims == 2;
+    const bool shader_changed = n->firstChild() != nullptr
+            && static_cast<MultiTraceMaterial*>(static_cast<QSGGeometryNode*>(n->firstChild())->material())->m_one_dim != one_dim;
+
+    if (!supported || shader_changed) {
+        // remove child node if there is no data source or the data dimensions changed
+        if (n->firstChild() != nullptr) {
+            n_geom = static_cast<QSGGeometryNode*>(n->firstChild());
+            n->removeAllChildNodes();
+            delete n_geom;
+        }
+        if (!supported) {
+            // return empty node
+            return n;
+        }
+    }
+
+    QSGNode::DirtyState dirty_state = QSGNode::DirtyMaterial;
+
+    if (n->firstChild() == nullptr) {
+        // create child node if there is a data source
+        n_geom = new QSGGeometryNode();
+        n_geom->setFlag(QSGNode::OwnedByParent);
+        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0, 0, QSGGeometry::UnsignedIntType);
+        geometry->setDrawingMode(GL_LINES);
+        material = new MultiTraceMaterial(one_dim);
+        material->m_texture_data = m_source->textureProvider()->texture();
+        n_geom->setGeometry(geometry);
+        n_geom->setFlag(QSGNode::OwnsGeometry);
+        n_geom->setMaterial(material);
+        n_geom->setFlag(QSGNode::OwnsMaterial);
+        n->appendChildNode(n_geom);
+        m_new_traces = true;
+        m_new_source = false;
+    }
+
+    // ** graph node and data source can be considered valid from here on **
+
+    n_geom = static_cast<QSGGeometryNode*>(n->firstChild());
+    geometry = n_geom->geometry();
+    material = static_cast<MultiTraceMaterial*>(n_geom->material());
+
+    // check for data source change
+    if (m_new_source) {
+        material->m_texture_data = m_source->textureProvider()->texture();
+        m_new_source = false;
+    }
+
+    // check if the data texture should be updated
+    if (m_new_data) {
+        static_cast<QSGDynamicTexture*>(material->m_texture_data)->updateTexture();
+        m_new_data = false;
+    }
+
+    // rows of 2D data are traces, the y values of 1D xy data are a single trace
+    // (ring buffers hold points of 1D data or traces of 2D data, only the valid ones are drawn oldest first)
+    const bool ring = m_source->streaming();
+    int num_samples = m_source->dataWidth();
+    if (one_dim) {
+        num_samples = (ring ? m_source->streamLength() : m_source->dataWidth()) / 2;
+    }
+    const int num_traces = one_dim ? 1 : (ring ? m_source->streamLength() : m_source->dataHeight());
+    material->m_shift = ring ? (one_dim ? m_source->streamOffset() / 2 : m_source->streamOffset()) : 0;
+    if (material->m_num_samples != num_samples || material->m_num_traces != num_traces) {
+        updateTraceGeometry(geometry, num_samples, num_traces);
+        material->m_num_samples = num_samples;
+        material->m_num_traces = num_traces;
+        m_new_traces = true;
+        dirty_state |= QSGNode::DirtyGeometry;
+    }
+    geometry->setLineWidth(static_cast<float>(m_linewidth));
+
+    // colours and offsets of all traces in one small table
+    if (m_new_traces) {
+        updateTraceTable(material->m_texture_traces, num_traces, m_trace_colors, m_trace_spacing, m_trace_offsets);
+        m_new_traces = false;
+    }
+
+    // update material parameters
+    // (texture values of integer data types are normalized, values are scaled back in the shader)
+    material->m_size = QSizeF(width(), height());
+    material->m_scale = QSizeF(1. / m_view_rect.width(), 1. / m_view_rect.height());
+    material->m_offset = m_view_rect.topLeft();
+    material->m_value_scale = m_source->valueScale();
+
+    n->markDirty(dirty_state);
+    n_geom->markDirty(dirty_state);
+    return n;
+}
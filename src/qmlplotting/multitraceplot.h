@@ -0,0 +1,52 @@
+#ifndef MULTITRACEPLOT_H
+#define MULTITRACEPLOT_H
+
+#include <QColor>
+#include <QVariantList>
+#include "dataclient.h"
+
+// Line plot of all rows of a 2D data source (channels x samples) in a single draw call,
+// x is the sample index, each trace is shifted by its offset and drawn in its colour.
+// The y values of 1D xy data are a single trace, ring buffers are drawn oldest points (1D) or traces (2D) first,
+// 3D data is not drawn.
+class MultiTracePlot : public DataClient
+{
+    Q_OBJECT
+    Q_PROPERTY(QRectF viewRect MEMBER m_view_rect WRITE setViewRect NOTIFY viewRectChanged)
+    Q_PROPERTY(double lineWidth MEMBER m_linewidth WRITE setLineWidth NOTIFY lineWidthChanged)
+    Q_PROPERTY(QVariantList traceColors MEMBER m_trace_colors WRITE setTraceColors NOTIFY traceColorsChanged)
+    Q_PROPERTY(double traceSpacing MEMBER m_trace_spacing WRITE setTraceSpacing NOTIFY traceSpacingChanged)
+    Q_PROPERTY(QVariantList traceOffsets MEMBER m_trace_offsets WRITE setTraceOffsets NOTIFY traceOffsetsChanged)
+
+public:
+    explicit MultiTracePlot(QQuickItem* parent = nullptr);
+    ~MultiTracePlot() override;
+
+    void setViewRect(const QRectF& viewrect);
+    void setLineWidth(double width);
+    // Colours are repeated if there are more traces than colours
+    void setTraceColors(const QVariantList& colors);
+    // Offset of trace i is traceOffsets[i] if given, i*traceSpacing otherwise
+    void setTraceSpacing(double spacing);
+    void setTraceOffsets(const QVariantList& offsets);
+
+signals:
+    void viewRectChanged(const QRectF& viewrect);
+    void lineWidthChanged(double width);
+    void traceColorsChanged(const QVariantList& colors);
+    void traceSpacingChanged(double spacing);
+    void traceOffsetsChanged(const QVariantList& offsets);
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* updatePaintNodeData) override;
+
+private:
+    QRectF m_view_rect = {0, 0, 1, 1};
+    double m_linewidth = 1.;
+    QVariantList m_trace_colors;
+    double m_trace_spacing = 1.;
+    QVariantList m_trace_offsets;
+    bool m_new_traces = true;
+};
+
+#endif // MULTITRACEPLOT_H
@@ -0,0 +1,107 @@
+#include "parallelfor.h"
+
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+
+// Chunks per thread, more chunks balance threads which start late or run slower
+static const int ChunksPerThread = 4;
+
+static std::atomic<int> s_thread_budget(0);
+
+// Shared by the calling thread and the pool tasks of one loop, tasks may outlive the loop
+struct LoopState
+{
+    const std::function<void(int64_t, int64_t)>* body = nullptr;
+    int64_t size = 0;
+    int64_t chunk_size = 0;
+    int64_t num_chunks = 0;
+    std::atomic<int64_t> next_chunk{0};
+    QSemaphore done;
+
+    // Process chunks until none are left, the body is only accessed while the loop waits for a claimed chunk
+    void run() {
+        for (;;) {
+            const int64_t chunk = next_chunk.fetch_add(1);
+            if (chunk >= num_chunks) {
+                return;
+            }
+            const int64_t begin = chunk * chunk_size;
+            (*body)(begin, std::min(begin + chunk_size, size));
+            done.release();
+        }
+    }
+};
+
+class LoopTask : public QRunnable
+{
+public:
+    explicit LoopTask(std::shared_ptr<LoopState> state) : m_state(std::move(state)) {}
+    void run() override {
+        m_state->run();
+    }
+
+private:
+    std::shared_ptr<LoopState> m_state;
+};
+
+static QThreadPool& loopPool()
+{
+    static QThreadPool pool;
+    static const bool initialized = [] {
+        pool.setMaxThreadCount(std::max(parallelThreadBudget() - 1, 1));
+        return true;
+    }();
+    Q_UNUSED(initialized);
+    return pool;
+}
+
+int parallelThreadBudget()
+{
+    int budget = s_thread_budget.load();
+    if (budget == 0) {
+        bool ok = false;
+        const int threads = qEnvironmentVariableIntValue("QMLPLOTTING_THREADS", &ok);
+        budget = std::max((ok && threads > 0) ? threads : QThread::idealThreadCount(), 1);
+        s_thread_budget.store(budget);
+    }
+    return budget;
+}
+
+void setParallelThreadBudget(int threads)
+{
+    threads = std::max(threads, 1);
+    s_thread_budget.store(threads);
+    loopPool().setMaxThreadCount(std::max(threads - 1, 1));
+}
+
+void parallelFor(int64_t size, int64_t grain, const std::function<void(int64_t, int64_t)>& body)
+{
+    if (size <= 0) {
+        return;
+    }
+    grain = std::max<int64_t>(grain, 1);
+    const int budget = parallelThreadBudget();
+    if (budget <= 1 || size <= grain) {
+        body(0, size);
+        return;
+    }
+
+    auto state = std::make_shared<LoopState>();
+    state->body = &body;
+    state->size = size;
+    state->chunk_size = std::max(grain, (size + ChunksPerThread * budget - 1) / (ChunksPerThread * budget));
+    state->num_chunks = (size + state->chunk_size - 1) / state->chunk_size;
+
+    const auto num_tasks = static_cast<int>(std::min<int64_t>(budget - 1, state->num_chunks - 1));
+    for (int i = 0; i < num_tasks; ++i) {
+        loopPool().start(new LoopTask(state));
+    }
+    state->run();
+    state->done.acquire(static_cast<int>(state->num_chunks));
+}
@@ -0,0 +1,24 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <cstdint>
+#include <functional>
+
+/**
+ * Chunked parallel loop on a thread pool shared by all data kernels.
+ *
+ * The range [0, size) is split into chunks of at least grain elements, body(begin, end) is called once per chunk.
+ * The calling thread processes chunks as well and returns when all chunks are done, ranges of up to grain
+ * elements run inline. Chunks must not depend on each other.
+ */
+void parallelFor(int64_t size, int64_t grain, const std::function<void(int64_t, int64_t)>& body);
+
+// Default grain of element wise kernels, large enough to amortize scheduling
+constexpr int64_t ParallelGrainSize = 1 << 16;
+
+// Maximum number of threads per loop including the calling thread, 1 disables threading.
+// Defaults to the QMLPLOTTING_THREADS environment variable or the number of cores.
+int parallelThreadBudget();
+void setParallelThreadBudget(int threads);
+
+#endif // PARALLELFOR_H
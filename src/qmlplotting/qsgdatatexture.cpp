@@ -1,7 +1,9 @@
 #include "qsgdatatexture.h"
+#include "renderstats.h"
 #include <QOpenGLContext>
 #include <cstdint>
 #include <QtGlobal>
+#include <algorithm>
 
 template <typename T>
 struct GlMap {
@@ -14,13 +16,30 @@ struct GlMap {
     }
     static const GLint internalFormats[5];
     static const GLenum dataType;
+    static const double valueScale;
 };
 
 template<> const GLint GlMap<float>::internalFormats[5] = {0, GL_R32F, GL_RG32F, GL_RGB32F, GL_RGBA32F};
 template<> const GLenum GlMap<float>::dataType = GL_FLOAT;
+template<> const double GlMap<float>::valueScale = 1.;
 
 template<> const GLint GlMap<uint8_t>::internalFormats[5] = {0, GL_R8, GL_RG8, GL_RGB8, GL_RGBA8};
 template<> const GLenum GlMap<uint8_t>::dataType = GL_UNSIGNED_BYTE;
+template<> const double GlMap<uint8_t>::valueScale = 1. / 255.;
+
+template<> const GLint GlMap<uint16_t>::internalFormats[5] = {0, GL_R16, GL_RG16, GL_RGB16, GL_RGBA16};
+template<> const GLenum GlMap<uint16_t>::dataType = GL_UNSIGNED_SHORT;
+template<> const double GlMap<uint16_t>::valueScale = 1. / 65535.;
+
+// Signed normalized values map to [-1, 1], the exact mapping of the most negative value depends on the GL version
+template<> const GLint GlMap<int16_t>::internalFormats[5] = {0, GL_R16_SNORM, GL_RG16_SNORM, GL_RGB16_SNORM, GL_RGBA16_SNORM};
+template<> const GLenum GlMap<int16_t>::dataType = GL_SHORT;
+template<> const double GlMap<int16_t>::valueScale = 1. / 32767.;
+
+// There are no normalized 32 bit integer formats, values are normalized and stored as float
+template<> const GLint GlMap<int32_t>::internalFormats[5] = {0, GL_R32F, GL_RG32F, GL_RGB32F, GL_RGBA32F};
+template<> const GLenum GlMap<int32_t>::dataType = GL_INT;
+template<> const double GlMap<int32_t>::valueScale = 1. / 2147483647.;
 
 
 template<typename T>
@@ -40,6 +59,9 @@ QSGDataTexture<T>::~QSGDataTexture() {
         }
         glDeleteTextures(1, &m_id_texture);
     }
+    if (m_num_pixel_buffers > 0) {
+        glDeleteBuffers(m_num_pixel_buffers, m_pixel_buffer_ids);
+    }
 }
 
 template<typename T>
@@ -65,16 +87,20 @@ bool QSGDataTexture<T>::hasAlphaChannel() const {
 
 template<typename T>
 bool QSGDataTexture<T>::hasMipmaps() const {
-    return false;
+    return m_num_levels > 0;
 }
 
 template<typename T>
 void QSGDataTexture<T>::bind() {
+    QMLPLOTTING_TRACE_SCOPE("QSGDataTexture::bind");
 
     if (m_id_texture == 0u) {
         glGenTextures(1, &m_id_texture);
     }
     GLint filter = (filtering() == Linear) ? GL_LINEAR : GL_NEAREST;
+    // reduced levels are selected by footprint, values of different levels are not blended
+    GLint mip_filter = (filtering() == Linear) ? GL_LINEAR_MIPMAP_NEAREST : GL_NEAREST_MIPMAP_NEAREST;
+    const int num_levels = m_num_levels;
 
     switch (m_num_dims) {
     case 1:
@@ -85,10 +111,11 @@ void QSGDataTexture<T>::bind() {
         break;
     case 2:
         glBindTexture(GL_TEXTURE_2D, m_id_texture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (m_num_levels > 0) ? mip_filter : filter);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        // rows of ring buffers wrap around
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (verticalWrapMode() == Repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
         break;
     case 3:
         glBindTexture(GL_TEXTURE_3D, m_id_texture);
@@ -109,20 +136,88 @@ void QSGDataTexture<T>::bind() {
         const GLenum format = GlMap<T>::dataFormat(m_num_components);
         const GLenum type = GlMap<T>::dataType;
 
-        // upload data as 1D or 2D texture
+        // upload from a pixel buffer or external memory if set, rows are tightly packed
+        const void* data = (m_external_data != nullptr) ? static_cast<const void*>(m_external_data) : m_buffer.constData();
+        if (m_pixel_buffer_pending >= 0) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixel_buffer_ids[m_pixel_buffer_pending]);
+            data = nullptr;
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        // reuse texture storage if size and format did not change
+        bool reuse_storage = (m_storage_num_dims == m_num_dims) && (m_storage_num_components == m_num_components);
+        for (int i = 0; i < m_num_dims; ++i) {
+            reuse_storage = reuse_storage && (m_storage_dims[i] == m_dims[i]);
+        }
+
+        // upload data as 1D, 2D or 3D texture
         switch (m_num_dims) {
         case 1:
-            glTexImage1D(GL_TEXTURE_1D, 0, internal_format, m_dims[0], 0, format, type, m_buffer.data());
+            if (reuse_storage) {
+                glTexSubImage1D(GL_TEXTURE_1D, 0, 0, m_dims[0], format, type, data);
+            } else {
+                glTexImage1D(GL_TEXTURE_1D, 0, internal_format, m_dims[0], 0, format, type, data);
+            }
             break;
         case 2:
-            glTexImage2D(GL_TEXTURE_2D, 0, internal_format, m_dims[0], m_dims[1], 0, format, type, m_buffer.data());
+            if (reuse_storage) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_dims[0], m_dims[1], format, type, data);
+            } else {
+                glTexImage2D(GL_TEXTURE_2D, 0, internal_format, m_dims[0], m_dims[1], 0, format, type, data);
+            }
             break;
         case 3:
-            glTexImage3D(GL_TEXTURE_3D, 0, internal_format, m_dims[0], m_dims[1], m_dims[2], 0, format, type, m_buffer.data());
+            if (reuse_storage) {
+                glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, m_dims[0], m_dims[1], m_dims[2], format, type, data);
+            } else {
+                glTexImage3D(GL_TEXTURE_3D, 0, internal_format, m_dims[0], m_dims[1], m_dims[2], 0, format, type, data);
+            }
             break;
         default:
-            return;
+            break;
+        }
+        m_storage_num_dims = m_num_dims;
+        m_storage_num_components = m_num_components;
+        for (int i = 0; i < 3; ++i) {
+            m_storage_dims[i] = m_dims[i];
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        if (m_pixel_buffer_pending >= 0) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            m_pixel_buffer_pending = -1;
+        }
+
+        // reduced levels do not match the new base level
+        if (m_num_levels > 0) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+            m_num_levels = 0;
+        }
+    }
+
+    if (m_mip_needs_upload && m_num_dims == 2) {
+        m_mip_needs_upload = false;
+        const GLint internal_format = GlMap<T>::internalFormat(m_num_components);
+        const GLenum format = GlMap<T>::dataFormat(m_num_components);
+        const GLenum type = GlMap<T>::dataType;
+        const T* data = reinterpret_cast<const T*>(m_mip_buffer.constData());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        int width = m_dims[0];
+        int height = m_dims[1];
+        for (int level = 1; level <= m_mip_num_levels; ++level) {
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+            glTexImage2D(GL_TEXTURE_2D, level, internal_format, width, height, 0, format, type, data);
+            data += width * height * m_num_components;
         }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_mip_num_levels);
+        m_num_levels = m_mip_num_levels;
+        m_mip_buffer.clear();
+    }
+
+    // minification filter depends on the levels present
+    if (m_num_dims == 2 && m_num_levels != num_levels) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (m_num_levels > 0) ? mip_filter : filter);
     }
 }
 
@@ -151,6 +246,7 @@ T *QSGDataTexture<T>::allocateData(const int *dims, int num_dims, int num_compon
 
     m_num_dims = num_dims;
     m_num_components = num_components;
+    m_pixel_buffer_pending = -1;
     return reinterpret_cast<T*>(m_buffer.data());
 }
 
@@ -177,7 +273,179 @@ T* QSGDataTexture<T>::allocateData3D(int width, int height, int depth, int num_c
 template<typename T>
 void QSGDataTexture<T>::commitData()
 {
+    RenderStats::addUploadBytes(m_buffer.size());
+    m_needs_upload = true;
+}
+
+template<typename T>
+void QSGDataTexture<T>::uploadData(const T* data, const int* dims, int num_dims, int num_components)
+{
+    if (num_components < 1 || num_components > 4) {
+        return;
+    }
+    if (num_dims < 1 || num_dims > 3) {
+        return;
+    }
+    for (int i = 0; i < num_dims; ++i) {
+        m_dims[i] = dims[i];
+    }
+    m_num_dims = num_dims;
+    m_num_components = num_components;
+
+    int num_elements = num_components;
+    for (int i = 0; i < num_dims; ++i) {
+        num_elements *= dims[i];
+    }
+    RenderStats::addUploadBytes(static_cast<qint64>(num_elements) * static_cast<qint64>(sizeof(T)));
+
+    // upload immediately from external memory (requires current OpenGL context), release staging buffer
+    m_buffer.clear();
+    m_pixel_buffer_pending = -1;
+    m_external_data = data;
     m_needs_upload = true;
+    bind();
+    m_external_data = nullptr;
+}
+
+template<typename T>
+bool QSGDataTexture<T>::uploadRegion(const T* data, int row_length, int x, int y, int width, int height, int level)
+{
+    // partial updates require existing texture storage, limited to 1D and 2D textures
+    if (m_id_texture == 0u || m_needs_upload || m_storage_num_dims != m_num_dims || m_num_dims > 2) {
+        return false;
+    }
+    // reduced levels of 2D textures must have been uploaded
+    if (level > 0 && (m_num_dims != 2 || m_mip_needs_upload || level > m_num_levels)) {
+        return false;
+    }
+    int storage_width = m_storage_dims[0];
+    int storage_height = (m_num_dims == 2) ? m_storage_dims[1] : 1;
+    for (int i = 0; i < level; ++i) {
+        storage_width = std::max(storage_width / 2, 1);
+        storage_height = std::max(storage_height / 2, 1);
+    }
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > storage_width || y + height > storage_height) {
+        return false;
+    }
+
+    RenderStats::addUploadBytes(static_cast<qint64>(width) * height * m_num_components * static_cast<qint64>(sizeof(T)));
+
+    // upload region, rows of the source data are row_length pixels apart
+    const GLenum format = GlMap<T>::dataFormat(m_num_components);
+    const GLenum type = GlMap<T>::dataType;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
+    if (m_num_dims == 1) {
+        glBindTexture(GL_TEXTURE_1D, m_id_texture);
+        glTexSubImage1D(GL_TEXTURE_1D, 0, x, width, format, type, data);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, m_id_texture);
+        glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, format, type, data);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    return true;
+}
+
+template<typename T>
+void QSGDataTexture<T>::setMipLevels(const T* levels, int num_levels)
+{
+    // count elements of all levels of the current base size
+    int num_elements = 0;
+    int width = m_dims[0];
+    int height = m_dims[1];
+    for (int level = 1; level <= num_levels; ++level) {
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+        num_elements += width * height * m_num_components;
+    }
+    m_mip_buffer = QByteArray(reinterpret_cast<const char*>(levels), num_elements * static_cast<int>(sizeof(T)));
+    RenderStats::addUploadBytes(m_mip_buffer.size());
+    m_mip_num_levels = num_levels;
+    m_mip_needs_upload = true;
+}
+
+template<typename T>
+void QSGDataTexture<T>::setPixelBuffers(int count)
+{
+    count = qBound(0, count, MaxPixelBuffers);
+    if (count == m_num_pixel_buffers) {
+        return;
+    }
+    if (m_num_pixel_buffers > 0) {
+        glDeleteBuffers(m_num_pixel_buffers, m_pixel_buffer_ids);
+        std::fill(m_pixel_buffer_ids, m_pixel_buffer_ids + MaxPixelBuffers, 0u);
+        std::fill(m_pixel_buffer_sizes, m_pixel_buffer_sizes + MaxPixelBuffers, 0);
+    }
+    if (m_pixel_buffer_pending >= 0) {
+        // scheduled data is gone with its buffer
+        m_pixel_buffer_pending = -1;
+        m_needs_upload = false;
+    }
+    m_num_pixel_buffers = count;
+    m_pixel_buffer_next = 0;
+    m_pixel_buffer_mapped = -1;
+    if (count > 0) {
+        glGenBuffers(count, m_pixel_buffer_ids);
+    }
+}
+
+template<typename T>
+T* QSGDataTexture<T>::mapData(const int* dims, int num_dims, int num_components)
+{
+    if (m_num_pixel_buffers == 0 || m_pixel_buffer_mapped >= 0) {
+        return nullptr;
+    }
+    if (num_components < 1 || num_components > 4) {
+        return nullptr;
+    }
+    if (num_dims < 1 || num_dims > 3) {
+        return nullptr;
+    }
+    int num_elements = num_components;
+    for (int i = 0; i < num_dims; ++i) {
+        m_dims[i] = dims[i];
+        num_elements *= dims[i];
+    }
+    m_num_dims = num_dims;
+    m_num_components = num_components;
+    m_buffer.clear();
+
+    // buffers keep their storage, the transfer from a buffer finished while the other buffers of the ring were
+    // written. Storage is only reallocated if the size changed, which orphans data of a transfer still in flight.
+    const int index = m_pixel_buffer_next;
+    m_pixel_buffer_next = (index + 1) % m_num_pixel_buffers;
+    const auto num_bytes = static_cast<GLsizeiptr>(num_elements) * static_cast<GLsizeiptr>(sizeof(T));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixel_buffer_ids[index]);
+    if (m_pixel_buffer_sizes[index] != num_bytes) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, num_bytes, nullptr, GL_STREAM_DRAW);
+        m_pixel_buffer_sizes[index] = num_bytes;
+    }
+    void* data = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (data == nullptr) {
+        return nullptr;
+    }
+    RenderStats::addUploadBytes(static_cast<qint64>(num_elements) * static_cast<qint64>(sizeof(T)));
+    m_pixel_buffer_mapped = index;
+    return static_cast<T*>(data);
+}
+
+template<typename T>
+bool QSGDataTexture<T>::unmapData()
+{
+    if (m_pixel_buffer_mapped < 0) {
+        return false;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixel_buffer_ids[m_pixel_buffer_mapped]);
+    const bool valid = (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (valid) {
+        m_pixel_buffer_pending = m_pixel_buffer_mapped;
+        m_needs_upload = true;
+    }
+    m_pixel_buffer_mapped = -1;
+    return valid;
 }
 
 template<typename T>
@@ -186,6 +454,12 @@ int QSGDataTexture<T>::getDim(int dim)
     return m_dims[dim];
 }
 
+template<typename T>
+double QSGDataTexture<T>::valueScale()
+{
+    return GlMap<T>::valueScale;
+}
+
 template<typename T>
 bool QSGDataTexture<T>::updateTexture()
 {
@@ -195,4 +469,7 @@ bool QSGDataTexture<T>::updateTexture()
 
 // Explicitly instantiate data texture classes in this unit
 template class QSGDataTexture<uint8_t>;
+template class QSGDataTexture<uint16_t>;
+template class QSGDataTexture<int16_t>;
+template class QSGDataTexture<int32_t>;
 template class QSGDataTexture<float>;
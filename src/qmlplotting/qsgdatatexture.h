@@ -4,6 +4,7 @@
 #include <QSGDynamicTexture>
 #include <QByteArray>
 #include <QOpenGLFunctions_2_0>
+#include <cstdint>
 
 
 template<typename T>
@@ -24,9 +25,29 @@ public:
     T* allocateData2D(int width, int height, int num_components);
     T* allocateData3D(int width, int height, int depth, int num_components);
     void commitData();
+    void uploadData(const T* data, const int* dims, int num_dims, int num_components);
+    // Upload a region of the base level or of an uploaded reduced level, false if there is no storage for it
+    bool uploadRegion(const T* data, int row_length, int x, int y, int width, int height, int level = 0);
+    // Set reduced mip levels 1..num_levels of 2D textures, packed consecutively with OpenGL mipmap sizes.
+    // Levels are uploaded on the next bind after the base level, uploading a new base level drops them.
+    void setMipLevels(const T* levels, int num_levels);
+
+    // Ring of pixel buffer objects for full uploads, 0 disables them. Data written into a mapped buffer is
+    // transferred on the next bind without stalling, the ring avoids writing a buffer still being transferred.
+    // Buffers are not orphaned on every map, only when the upload size changes.
+    static constexpr int MaxPixelBuffers = 3;
+    void setPixelBuffers(int count);
+    int pixelBuffers() const {return m_num_pixel_buffers;}
+    // Map the next pixel buffer for writing (requires current OpenGL context), null if disabled or failed
+    T* mapData(const int* dims, int num_dims, int num_components);
+    // Unmap the buffer and schedule its upload, false if the buffer contents were lost
+    bool unmapData();
 
     int getDim(int dim);
 
+    // Factor between stored values and values sampled in shaders (normalized integer formats)
+    static double valueScale();
+
     bool updateTexture() override;
 
 private:
@@ -35,10 +56,29 @@ private:
     int m_dims[3] = {0, 0, 0};
     int m_num_components = 0;
     QByteArray m_buffer;
+    const T* m_external_data = nullptr;
     bool m_needs_upload = false;
+    int m_storage_num_dims = 0;
+    int m_storage_dims[3] = {0, 0, 0};
+    int m_storage_num_components = 0;
+    QByteArray m_mip_buffer;
+    int m_mip_num_levels = 0;
+    bool m_mip_needs_upload = false;
+    int m_num_levels = 0;
+    int m_num_pixel_buffers = 0;
+    unsigned int m_pixel_buffer_ids[MaxPixelBuffers] = {0, 0, 0};
+    // allocated storage of each buffer in bytes
+    qint64 m_pixel_buffer_sizes[MaxPixelBuffers] = {0, 0, 0};
+    int m_pixel_buffer_next = 0;
+    int m_pixel_buffer_mapped = -1;
+    // buffer holding the data of the next upload, -1 uploads from client memory
+    int m_pixel_buffer_pending = -1;
 };
 
 extern template class QSGDataTexture<float>;
 extern template class QSGDataTexture<uint8_t>;
+extern template class QSGDataTexture<uint16_t>;
+extern template class QSGDataTexture<int16_t>;
+extern template class QSGDataTexture<int32_t>;
 
 #endif // QSGDATATEXTURE_H
@@ -0,0 +1,51 @@
+#include "renderstats.h"
+
+Q_LOGGING_CATEGORY(lcTrace, "qmlplotting.trace", QtWarningMsg)
+
+// Counters of the updatePaintNode call running on this thread, if any
+static thread_local RenderStats* s_current = nullptr;
+
+void RenderStats::addVertices(qint64 count)
+{
+    if (s_current != nullptr) {
+        s_current->vertices += count;
+    }
+}
+
+void RenderStats::addUploadBytes(qint64 bytes)
+{
+    if (s_current != nullptr) {
+        s_current->upload_bytes += bytes;
+    }
+}
+
+void RenderStats::addConvertedValues(qint64 count)
+{
+    if (s_current != nullptr) {
+        s_current->converted_values += count;
+    }
+}
+
+PaintScope::PaintScope(RenderStats& stats, QObject* receiver)
+    : m_stats(stats)
+    , m_previous(s_current)
+    , m_receiver(receiver)
+{
+    // nested work of disabled counters must not be added to an enclosing scope either
+    s_current = m_stats.enabled ? &m_stats : nullptr;
+    if (m_stats.enabled) {
+        m_stats.vertices = 0;
+        m_timer.start();
+    }
+}
+
+PaintScope::~PaintScope()
+{
+    s_current = m_previous;
+    if (m_stats.enabled) {
+        m_stats.paint_time = m_timer.nsecsElapsed() * 1e-6;
+        if (m_receiver != nullptr) {
+            QMetaObject::invokeMethod(m_receiver, "renderStatsChanged", Qt::QueuedConnection);
+        }
+    }
+}
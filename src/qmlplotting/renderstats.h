@@ -0,0 +1,75 @@
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QObject>
+
+/**
+ * Performance counters of a data client, written on the render thread while the GUI thread is blocked.
+ *
+ * A PaintScope in updatePaintNode times the call and makes the counters current, texture uploads, conversions
+ * and geometry loops running inside the call are added to them. Work outside of a paint scope is not counted.
+ * Counters are opt-in, paint scopes of disabled counters do nothing.
+ */
+struct RenderStats
+{
+    bool enabled = false;
+    // duration of the last updatePaintNode in ms
+    double paint_time = 0.;
+    // vertices generated by the last updatePaintNode
+    qint64 vertices = 0;
+    // totals since creation
+    qint64 upload_bytes = 0;
+    qint64 converted_values = 0;
+
+    static void addVertices(qint64 count);
+    static void addUploadBytes(qint64 bytes);
+    static void addConvertedValues(qint64 count);
+};
+
+class PaintScope
+{
+public:
+    // The receiver gets a queued renderStatsChanged call when the scope of enabled counters ends
+    PaintScope(RenderStats& stats, QObject* receiver);
+    ~PaintScope();
+
+private:
+    RenderStats& m_stats;
+    RenderStats* m_previous;
+    QObject* m_receiver;
+    QElapsedTimer m_timer;
+};
+
+// Trace scopes log their duration to the qmlplotting.trace category, e.g. QT_LOGGING_RULES="qmlplotting.trace.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcTrace)
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        : m_name(lcTrace().isDebugEnabled() ? name : nullptr)
+    {
+        if (m_name != nullptr) {
+            m_timer.start();
+        }
+    }
+    ~TraceScope() {
+        if (m_name != nullptr) {
+            qCDebug(lcTrace, "%s %.3f ms", m_name, m_timer.nsecsElapsed() * 1e-6);
+        }
+    }
+
+private:
+    const char* m_name;
+    QElapsedTimer m_timer;
+};
+
+#ifdef QMLPLOTTING_NO_TRACE
+#define QMLPLOTTING_TRACE_SCOPE(name)
+#else
+#define QMLPLOTTING_TRACE_SCOPE(name) TraceScope trace_scope(name)
+#endif
+
+#endif // RENDERSTATS_H
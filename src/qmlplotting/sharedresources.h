@@ -0,0 +1,59 @@
+#ifndef SHAREDRESOURCES_H
+#define SHAREDRESOURCES_H
+
+#include <QtGlobal>
+#include <map>
+#include <memory>
+#include <tuple>
+
+/**
+ * Render resources derived from the data of one source, shared by all clients showing the same data.
+ *
+ * Resources are owned by the scene graph nodes of the clients, the cache only keeps weak references. A resource
+ * is released with the last node using it, entries of older data generations expire when clients move on.
+ * Resources updated in place by the changes of the data use generation 0.
+ * Only accessed on the render thread while the GUI thread is blocked.
+ */
+class SharedResources
+{
+public:
+    // Resource types, each kind maps to a single C++ type
+    enum Kind {
+        XYPointTexture  // SharedPointTexture of xy points, see XYPlot vertex pulling
+    };
+
+    struct Key {
+        qint64 generation;
+        int kind;   // resource type and transform
+        int level;  // decimation level, 0 for full data
+        bool operator<(const Key& other) const {
+            return std::tie(generation, kind, level) < std::tie(other.generation, other.kind, other.level);
+        }
+    };
+
+    // Get the resource for key, create is called if there is none. created tells whether the resource
+    // is new and has to be filled by the caller.
+    template<typename T, typename Create>
+    std::shared_ptr<T> acquire(const Key& key, bool& created, Create&& create) {
+        // drop entries without owners
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            it = it->second.expired() ? m_entries.erase(it) : std::next(it);
+        }
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            created = false;
+            return std::static_pointer_cast<T>(it->second.lock());
+        }
+        std::shared_ptr<T> resource(create());
+        m_entries[key] = resource;
+        created = true;
+        return resource;
+    }
+
+    int size() const {return static_cast<int>(m_entries.size());}
+
+private:
+    std::map<Key, std::weak_ptr<void>> m_entries;
+};
+
+#endif // SHAREDRESOURCES_H
@@ -306,6 +306,7 @@ void SlicePlot::setFilled(bool filled)
 
 QSGNode *SlicePlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData *)
 {
+    PaintScope paint_scope(m_render_stats, this);
     QSGGeometryNode* n_geom;
     QSGGeometry *geometry;
     SlicePlotMaterial *material;
@@ -380,8 +381,10 @@ QSGNode *SlicePlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData
 
     //material->m_amplitude = - scale_val;
     //material->m_offset = off_val - 1./scale_val;
-    material->m_amplitude = 1. / (m_max_value - m_min_value);
-    material->m_offset = -m_min_value;
+    // texture values of integer data types are normalized, scale range accordingly
+    double value_scale = m_source->valueScale();
+    material->m_amplitude = 1. / ((m_max_value - m_min_value) * value_scale);
+    material->m_offset = -m_min_value * value_scale;
 
     material->m_p1 = m_p1;
     material->m_p2 = m_p2;
@@ -395,6 +398,7 @@ QSGNode *SlicePlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData
             geometry->vertexDataAsPoint2D()[1].set(0, 1);
             geometry->vertexDataAsPoint2D()[2].set(1, 0);
             geometry->vertexDataAsPoint2D()[3].set(1, 1);
+            RenderStats::addVertices(4);
             dirty_state |= QSGNode::DirtyGeometry;
         }
     } else {
@@ -405,6 +409,7 @@ QSGNode *SlicePlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData
                 double f = i * (1./m_num_segments);
                 data[2*i] = static_cast<float>(f);
             }
+            RenderStats::addVertices(m_num_segments+1);
             dirty_state |= QSGNode::DirtyGeometry;
         }
     }
@@ -5,10 +5,18 @@
 #include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QPainter>
+#include <QQuickWindow>
 #include <vector>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <cmath>
+#include <memory>
 #include "qsgdatatexture.h"
+#include "convertkernels.h"
+#include "decimation.h"
+#include "parallelfor.h"
+#include "colormaps.h"
 
 #ifndef M_PI
 #define M_PI		3.14159265358979323846
@@ -20,36 +28,102 @@
 class XYMarkerMaterial : public QSGMaterial
 {
 public:
-    XYMarkerMaterial() = default;
+    explicit XYMarkerMaterial(bool quads = false) : m_quads(quads) {
+        if (m_quads) {
+            setFlag(QSGMaterial::RequiresFullMatrix);
+        }
+    }
     QSGMaterialType *type() const override {
-        static QSGMaterialType type;
-        return &type;
+        static QSGMaterialType type[2];
+        return &type[m_quads ? 1 : 0];
     }
     QSGMaterialShader *createShader() const override;
     QSizeF m_size;
     QSizeF m_scale;
     QPointF m_offset;
+    bool m_logy = false;
     QColor m_markercolor;
     double m_markersize = 0;
     int m_markersegments = 0;
     bool m_markerborder = false;
     QSGDataTexture<uint8_t> m_markerimage;
+    QSGDataTexture<float>* m_points = nullptr;
+    // optional per-point sizes and colours of quad markers
+    QSGDataTexture<float>* m_sizes = nullptr;
+    QSGDataTexture<float>* m_colors = nullptr;
+    // colormap of scalar per-point values, colours are looked up at amplitude*(value + offset)
+    QSGDataTexture<float>* m_colormap = nullptr;
+    double m_cmap_amplitude = 1.;
+    double m_cmap_offset = 0.;
+    const bool m_quads;
 };
 
 class XYMarkerMaterialShader : public QSGMaterialShader
 {
 public:
+    explicit XYMarkerMaterialShader(bool quads) : m_quads(quads) {}
+
     const char *vertexShader() const override {
+        if (m_quads) {
+            // vertex holds point index and quad corner, points are fetched from the row major point texture
+            return GLSL(130,
+                in highp vec2 vertex;
+                uniform sampler2D points;
+                uniform sampler2D sizes;
+                uniform sampler2D colors;
+                uniform bool hassizes;
+                uniform bool hascolors;
+                uniform sampler2D cmap;
+                uniform bool colormapped;
+                uniform highp float camplitude;
+                uniform highp float coffset;
+                uniform highp mat4 matrix;
+                uniform highp vec2 size;
+                uniform highp vec2 scale;
+                uniform highp vec2 offset;
+                uniform bool logy;
+                uniform float msize;
+                uniform lowp vec4 mcolor;
+                out highp vec2 coord;
+                out highp float radius;
+                out lowp vec4 color;
+
+                void main() {
+                    const vec2 corners[6] = vec2[6](vec2(-1., -1.), vec2(1., -1.), vec2(-1., 1.),
+                                                    vec2(-1., 1.), vec2(1., -1.), vec2(1., 1.));
+                    int i = int(vertex.x);
+                    int w = textureSize(points, 0).x;
+                    ivec2 t = ivec2(i % w, i / w);
+                    highp vec2 v = texelFetch(points, t, 0).rg;
+                    if (logy) {
+                        v.y = log2(v.y) * 0.30102999566;
+                    }
+                    radius = 0.5 * (hassizes ? texelFetch(sizes, t, 0).r : msize);
+                    color = hascolors ? texelFetch(colors, t, 0) : mcolor;
+                    if (hascolors && colormapped) {
+                        color = texture(cmap, vec2(camplitude * (color.r + coffset), 0.));
+                    }
+                    coord = corners[int(vertex.y)] * (radius + 1.);
+                    highp vec2 p = (v - offset) * scale * size;
+                    gl_Position = matrix * vec4(p.x + coord.x, size.y - p.y + coord.y, 0., 1.);
+                }
+            );
+        }
         return GLSL(130,
             in highp vec4 vertex;
             uniform highp mat4 matrix;
             uniform highp vec2 size;
             uniform highp vec2 scale;
             uniform highp vec2 offset;
+            uniform bool logy;
             uniform float msize;
 
             void main() {
-                highp vec2 p = (vertex.xy - offset) * scale * size;
+                highp vec2 v = vertex.xy;
+                if (logy) {
+                    v.y = log2(v.y) * 0.30102999566;
+                }
+                highp vec2 p = (v - offset) * scale * size;
                 gl_Position = matrix * vec4(p.x, size.y - p.y, 0., 1.);
                 gl_PointSize = msize;
             }
@@ -57,6 +131,35 @@ public:
     }
 
     const char *fragmentShader() const override {
+        if (m_quads) {
+            // signed distance to circle or regular polygon with the first vertex on top
+            return GLSL(130,
+                uniform lowp float opacity;
+                uniform int segments;
+                uniform bool border;
+                in highp vec2 coord;
+                in highp float radius;
+                in lowp vec4 color;
+                out vec4 fragColor;
+
+                void main() {
+                    highp float d = length(coord) - radius;
+                    if (segments >= 3) {
+                        highp float half_sector = 3.14159265 / float(segments);
+                        highp float phi = mod(atan(coord.x, -coord.y), 2. * half_sector) - half_sector;
+                        d = length(coord) * cos(phi) - radius * cos(half_sector);
+                    }
+                    highp float aa = max(fwidth(d), 0.0001);
+                    lowp float coverage = clamp(0.5 - d / aa, 0., 1.);
+                    lowp vec3 rgb = color.rgb;
+                    if (border) {
+                        rgb = mix(rgb, vec3(0.), clamp(1.5 + d / aa, 0., 1.));
+                    }
+                    lowp float o = opacity * color.a * coverage;
+                    fragColor = vec4(rgb * o, o);
+                }
+            );
+        }
         return GLSL(130,
             uniform lowp float opacity;
             uniform lowp vec4 mcolor;
@@ -85,15 +188,29 @@ public:
         m_id_size = p->uniformLocation("size");
         m_id_scale = p->uniformLocation("scale");
         m_id_offset = p->uniformLocation("offset");
+        m_id_logy = p->uniformLocation("logy");
+        m_id_points = p->uniformLocation("points");
+        m_id_sizes = p->uniformLocation("sizes");
+        m_id_colors = p->uniformLocation("colors");
+        m_id_hassizes = p->uniformLocation("hassizes");
+        m_id_hascolors = p->uniformLocation("hascolors");
+        m_id_cmap = p->uniformLocation("cmap");
+        m_id_colormapped = p->uniformLocation("colormapped");
+        m_id_camplitude = p->uniformLocation("camplitude");
+        m_id_coffset = p->uniformLocation("coffset");
+        m_id_segments = p->uniformLocation("segments");
+        m_id_border = p->uniformLocation("border");
         m_id_msize = p->uniformLocation("msize");
         m_id_mcolor = p->uniformLocation("mcolor");
         m_id_mimage = p->uniformLocation("mimage");
     }
 
     void activate() override {
-        QOpenGLFunctions *glFuncs = QOpenGLContext::currentContext()->functions();
-        glFuncs->glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
-        glFuncs->glEnable(GL_POINT_SPRITE); // TODO: this is deprecated, but appears to be required on NVidia systems
+        if (!m_quads) {
+            QOpenGLFunctions *glFuncs = QOpenGLContext::currentContext()->functions();
+            glFuncs->glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+            glFuncs->glEnable(GL_POINT_SPRITE); // TODO: this is deprecated, but appears to be required on NVidia systems
+        }
     }
 
     void updateState(const RenderState& state, QSGMaterial* newMaterial, QSGMaterial*) override {
@@ -112,12 +229,40 @@ public:
         p->setUniformValue(m_id_size, material->m_size);
         p->setUniformValue(m_id_scale, material->m_scale);
         p->setUniformValue(m_id_offset, material->m_offset);
+        p->setUniformValue(m_id_logy, static_cast<GLint>(material->m_logy));
         p->setUniformValue(m_id_msize, float(material->m_markersize));
         p->setUniformValue(m_id_mcolor, material->m_markercolor);
 
-        // bind texture
-        p->setUniformValue(m_id_mimage, 0);
-        material->m_markerimage.bind();
+        if (!m_quads) {
+            // bind texture
+            p->setUniformValue(m_id_mimage, 0);
+            material->m_markerimage.bind();
+            return;
+        }
+
+        // glyph parameters of quad markers
+        p->setUniformValue(m_id_segments, material->m_markersegments);
+        p->setUniformValue(m_id_border, static_cast<GLint>(material->m_markerborder));
+        p->setUniformValue(m_id_hassizes, static_cast<GLint>(material->m_sizes != nullptr));
+        p->setUniformValue(m_id_hascolors, static_cast<GLint>(material->m_colors != nullptr));
+        p->setUniformValue(m_id_colormapped, static_cast<GLint>(material->m_colormap != nullptr));
+        p->setUniformValue(m_id_camplitude, float(material->m_cmap_amplitude));
+        p->setUniformValue(m_id_coffset, float(material->m_cmap_offset));
+
+        // bind point, size, colour and colormap textures to units 1 to 4
+        QOpenGLFunctions* gl = QOpenGLContext::currentContext()->functions();
+        const auto bindUnit = [&](int id, int unit, QSGDataTexture<float>* texture) {
+            if (texture != nullptr) {
+                p->setUniformValue(id, unit);
+                gl->glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + unit));
+                texture->bind();
+            }
+        };
+        bindUnit(m_id_points, 1, material->m_points);
+        bindUnit(m_id_sizes, 2, material->m_sizes);
+        bindUnit(m_id_colors, 3, material->m_colors);
+        bindUnit(m_id_cmap, 4, material->m_colormap);
+        gl->glActiveTexture(GL_TEXTURE0);
     }
 
 private:
@@ -126,41 +271,92 @@ private:
     int m_id_size;
     int m_id_scale;
     int m_id_offset;
+    int m_id_logy;
+    int m_id_points;
+    int m_id_sizes;
+    int m_id_colors;
+    int m_id_hassizes;
+    int m_id_hascolors;
+    int m_id_cmap;
+    int m_id_colormapped;
+    int m_id_camplitude;
+    int m_id_coffset;
+    int m_id_segments;
+    int m_id_border;
     int m_id_msize;
     int m_id_mcolor;
     int m_id_mimage;
+    const bool m_quads;
 };
 
-inline QSGMaterialShader* XYMarkerMaterial::createShader() const { return new XYMarkerMaterialShader; }
+inline QSGMaterialShader* XYMarkerMaterial::createShader() const { return new XYMarkerMaterialShader(m_quads); }
 
 
 class XYLineMaterial : public QSGMaterial
 {
 public:
+    explicit XYLineMaterial(bool pulling = false) : m_pulling(pulling) {
+        if (m_pulling) {
+            setFlag(QSGMaterial::RequiresFullMatrix);
+        }
+    }
     QSGMaterialType* type() const override {
-        static QSGMaterialType type;
-        return &type;
+        static QSGMaterialType type[2];
+        return &type[m_pulling ? 1 : 0];
     }
     QSGMaterialShader* createShader() const override;
     QSizeF m_size;
     QSizeF m_scale;
     QPointF m_offset;
+    bool m_logy = false;
     QColor m_color;
+    QSGDataTexture<float>* m_points = nullptr;
+    const bool m_pulling;
 };
 
 class XYLineMaterialShader : public QSGMaterialShader
 {
 public:
+    explicit XYLineMaterialShader(bool pulling) : m_pulling(pulling) {}
+
     const char* vertexShader() const override {
+        if (m_pulling) {
+            // fetch point from row major point texture by vertex index, the attribute is a placeholder
+            return GLSL(130,
+                in lowp float vertex;
+                uniform sampler2D points;
+                uniform highp mat4 matrix;
+                uniform highp vec2 size;
+                uniform highp vec2 scale;
+                uniform highp vec2 offset;
+                uniform bool logy;
+
+                void main() {
+                    int i = gl_VertexID;
+                    int w = textureSize(points, 0).x;
+                    highp vec2 v = texelFetch(points, ivec2(i % w, i / w), 0).rg;
+                    if (logy) {
+                        v.y = log2(v.y) * 0.30102999566;
+                    }
+                    highp vec2 p = (v - offset) * scale * size;
+                    gl_Position = matrix * vec4(p.x, size.y - p.y, 0., 1.);
+                }
+            );
+        }
         return GLSL(130,
             in highp vec4 vertex;
             uniform highp mat4 matrix;
             uniform highp vec2 size;
             uniform highp vec2 scale;
             uniform highp vec2 offset;
+            uniform bool logy;
 
             void main() {
-                highp vec2 p = (vertex.xy - offset) * scale * size;
+                highp vec2 v = vertex.xy;
+                if (logy) {
+                    v.y = log2(v.y) * 0.30102999566;
+                }
+                highp vec2 p = (v - offset) * scale * size;
                 gl_Position = matrix * vec4(p.x, size.y - p.y, 0., 1.);
             }
         );
@@ -193,6 +389,8 @@ public:
         m_id_size = p->uniformLocation("size");
         m_id_scale = p->uniformLocation("scale");
         m_id_offset = p->uniformLocation("offset");
+        m_id_logy = p->uniformLocation("logy");
+        m_id_points = p->uniformLocation("points");
         m_id_color = p->uniformLocation("color");
     }
 
@@ -212,7 +410,17 @@ public:
         p->setUniformValue(m_id_size, material->m_size);
         p->setUniformValue(m_id_scale, material->m_scale);
         p->setUniformValue(m_id_offset, material->m_offset);
+        p->setUniformValue(m_id_logy, static_cast<GLint>(material->m_logy));
         p->setUniformValue(m_id_color, material->m_color);
+
+        // bind point texture to unit 1
+        if (m_pulling && material->m_points != nullptr) {
+            QOpenGLFunctions* gl = QOpenGLContext::currentContext()->functions();
+            p->setUniformValue(m_id_points, 1);
+            gl->glActiveTexture(GL_TEXTURE1);
+            material->m_points->bind();
+            gl->glActiveTexture(GL_TEXTURE0);
+        }
     }
 
 private:
@@ -221,39 +429,85 @@ private:
     int m_id_size;
     int m_id_scale;
     int m_id_offset;
+    int m_id_logy;
+    int m_id_points;
     int m_id_color;
+    const bool m_pulling;
 };
 
-inline QSGMaterialShader* XYLineMaterial::createShader() const { return new XYLineMaterialShader; }
+inline QSGMaterialShader* XYLineMaterial::createShader() const { return new XYLineMaterialShader(m_pulling); }
 
 
 class XYFillMaterial : public QSGMaterial
 {
 public:
+    explicit XYFillMaterial(bool pulling = false) : m_pulling(pulling) {
+        if (m_pulling) {
+            setFlag(QSGMaterial::RequiresFullMatrix);
+        }
+    }
     QSGMaterialType* type() const override {
-        static QSGMaterialType type;
-        return &type;
+        static QSGMaterialType type[2];
+        return &type[m_pulling ? 1 : 0];
     }
     QSGMaterialShader* createShader() const override;
     QSizeF m_size;
     QSizeF m_scale;
     QPointF m_offset;
+    bool m_logy = false;
     QColor m_color;
+    QSGDataTexture<float>* m_points = nullptr;
+    const bool m_pulling;
 };
 
 class XYFillMaterialShader : public QSGMaterialShader
 {
 public:
+    explicit XYFillMaterialShader(bool pulling) : m_pulling(pulling) {}
+
     const char* vertexShader() const override {
+        if (m_pulling) {
+            // fetch point from row major point texture, even vertices are the baseline (x, 0)
+            return GLSL(130,
+                in lowp float vertex;
+                uniform sampler2D points;
+                uniform highp mat4 matrix;
+                uniform highp vec2 size;
+                uniform highp vec2 scale;
+                uniform highp vec2 offset;
+                uniform bool logy;
+
+                void main() {
+                    int i = gl_VertexID / 2;
+                    int w = textureSize(points, 0).x;
+                    highp vec2 v = texelFetch(points, ivec2(i % w, i / w), 0).rg;
+                    if (gl_VertexID % 2 == 0) {
+                        v.y = 0.;
+                    }
+                    if (logy) {
+                        // baseline and non-positive values are clamped to the lower view border
+                        v.y = (v.y > 0.) ? log2(v.y) * 0.30102999566 : offset.y;
+                    }
+                    highp vec2 p = (v - offset) * scale * size;
+                    gl_Position = matrix * vec4(p.x, size.y - p.y, 0., 1.);
+                }
+            );
+        }
         return GLSL(130,
             in highp vec4 vertex;
             uniform highp mat4 matrix;
             uniform highp vec2 size;
             uniform highp vec2 scale;
             uniform highp vec2 offset;
+            uniform bool logy;
 
             void main() {
-                highp vec2 p = (vertex.xy - offset) * scale * size;
+                highp vec2 v = vertex.xy;
+                if (logy) {
+                    // baseline and non-positive values are clamped to the lower view border
+                    v.y = (v.y > 0.) ? log2(v.y) * 0.30102999566 : offset.y;
+                }
+                highp vec2 p = (v - offset) * scale * size;
                 gl_Position = matrix * vec4(p.x, size.y - p.y, 0., 1.);
             }
         );
@@ -285,6 +539,8 @@ public:
         m_id_size = p->uniformLocation("size");
         m_id_scale = p->uniformLocation("scale");
         m_id_offset = p->uniformLocation("offset");
+        m_id_logy = p->uniformLocation("logy");
+        m_id_points = p->uniformLocation("points");
         m_id_color = p->uniformLocation("color");
     }
 
@@ -304,7 +560,17 @@ public:
         p->setUniformValue(m_id_size, material->m_size);
         p->setUniformValue(m_id_scale, material->m_scale);
         p->setUniformValue(m_id_offset, material->m_offset);
+        p->setUniformValue(m_id_logy, static_cast<GLint>(material->m_logy));
         p->setUniformValue(m_id_color, material->m_color);
+
+        // bind point texture to unit 1
+        if (m_pulling && material->m_points != nullptr) {
+            QOpenGLFunctions* gl = QOpenGLContext::currentContext()->functions();
+            p->setUniformValue(m_id_points, 1);
+            gl->glActiveTexture(GL_TEXTURE1);
+            material->m_points->bind();
+            gl->glActiveTexture(GL_TEXTURE0);
+        }
     }
 
 private:
@@ -313,10 +579,13 @@ private:
     int m_id_size;
     int m_id_scale;
     int m_id_offset;
+    int m_id_logy;
+    int m_id_points;
     int m_id_color;
+    const bool m_pulling;
 };
 
-inline QSGMaterialShader* XYFillMaterial::createShader() const { return new XYFillMaterialShader; }
+inline QSGMaterialShader* XYFillMaterial::createShader() const { return new XYFillMaterialShader(m_pulling); }
 
 
 XYPlot::XYPlot(QQuickItem *parent) : DataClient(parent)
@@ -329,6 +598,7 @@ void XYPlot::setViewRect(const QRectF &viewrect)
 {
     if (viewrect != m_view_rect) {
         m_view_rect = viewrect;
+        m_new_geometry = true;
         emit viewRectChanged(m_view_rect);
         update();
     }
@@ -429,32 +699,179 @@ void XYPlot::setLogY(bool enabled)
     if (m_logy != enabled) {
         m_logy = enabled;
         emit logYChanged(m_logy);
+        update();
+    }
+}
+
+void XYPlot::setDecimationEnabled(bool enabled)
+{
+    if (m_decimation != enabled) {
+        m_decimation = enabled;
+        emit decimationEnabledChanged(m_decimation);
+        m_new_data = true;
+        m_stream_revision = -1;
+        update();
+    }
+}
+
+void XYPlot::setVertexPulling(bool enabled)
+{
+    if (m_vertex_pulling != enabled) {
+        m_vertex_pulling = enabled;
+        emit vertexPullingChanged(m_vertex_pulling);
         m_new_data = true;
         update();
     }
 }
 
+void XYPlot::setMarkerColormap(const QString& colormap)
+{
+    if (m_markercolormap != colormap) {
+        // switching between RGBA and scalar colours changes the attribute layout
+        if (m_markercolormap.isEmpty() != colormap.isEmpty()) {
+            m_new_marker_attributes = true;
+        }
+        m_markercolormap = colormap;
+        m_new_colormap = true;
+        emit markerColormapChanged(m_markercolormap);
+        update();
+    }
+}
+
+void XYPlot::setMarkerColorMin(double value)
+{
+    if (m_markercolor_min != value) {
+        m_markercolor_min = value;
+        emit markerColorMinChanged(value);
+        update();
+    }
+}
+
+void XYPlot::setMarkerColorMax(double value)
+{
+    if (m_markercolor_max != value) {
+        m_markercolor_max = value;
+        emit markerColorMaxChanged(value);
+        update();
+    }
+}
+
+void XYPlot::markerAttributesChanged()
+{
+    m_new_marker_attributes = true;
+    update();
+}
+
+void XYPlot::setMarkerSizeSource(QQuickItem* item)
+{
+    auto* d = dynamic_cast<DataSource*>(item);
+    if (d == m_size_source) {
+        return;
+    }
+    if (m_size_source != nullptr) {
+        disconnect(m_size_source, &DataSource::dataChanged, this, &XYPlot::markerAttributesChanged);
+    }
+    if (d != nullptr) {
+        connect(d, &DataSource::dataChanged, this, &XYPlot::markerAttributesChanged);
+    }
+    m_size_source = d;
+    emit markerSizeSourceChanged(d);
+    markerAttributesChanged();
+}
+
+void XYPlot::setMarkerColorSource(QQuickItem* item)
+{
+    auto* d = dynamic_cast<DataSource*>(item);
+    if (d == m_color_source) {
+        return;
+    }
+    if (m_color_source != nullptr) {
+        disconnect(m_color_source, &DataSource::dataChanged, this, &XYPlot::markerAttributesChanged);
+    }
+    if (d != nullptr) {
+        connect(d, &DataSource::dataChanged, this, &XYPlot::markerAttributesChanged);
+    }
+    m_color_source = d;
+    emit markerColorSourceChanged(d);
+    markerAttributesChanged();
+}
+
+
+// Vertex layouts of the fill, line and marker geometry
+enum class VertexLayout {
+    Strip,      // xy vertices in data order
+    Ring,       // xy vertices at ring buffer positions, segments are indexed
+    Pulling,    // points are fetched from the point texture by gl_VertexID
+    Quads       // point index and corner of marker quads, points are fetched from the point texture
+};
+
+// Single byte placeholder, geometry needs an attribute but points are looked up by gl_VertexID
+// (float indices would only be exact up to 2^24 vertices, fills have two vertices per point)
+static const QSGGeometry::AttributeSet& indexAttributes()
+{
+    static QSGGeometry::Attribute attribute = QSGGeometry::Attribute::create(0, 1, GL_UNSIGNED_BYTE, false);
+    static QSGGeometry::AttributeSet attributes = {1, sizeof(quint8), &attribute};
+    return attributes;
+}
+
+// Point index and quad corner
+static const QSGGeometry::AttributeSet& quadAttributes()
+{
+    static QSGGeometry::Attribute attribute = QSGGeometry::Attribute::create(0, 2, GL_FLOAT, false);
+    static QSGGeometry::AttributeSet attributes = {1, 2 * sizeof(float), &attribute};
+    return attributes;
+}
+
+static QSGGeometry* createGeometry(VertexLayout layout, GLenum strip_mode, GLenum ring_mode)
+{
+    QSGGeometry* geometry;
+    switch (layout) {
+    case VertexLayout::Ring:
+        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0, 0, QSGGeometry::UnsignedIntType);
+        geometry->setDrawingMode(ring_mode);
+        break;
+    case VertexLayout::Pulling:
+        geometry = new QSGGeometry(indexAttributes(), 0);
+        geometry->setDrawingMode(strip_mode);
+        break;
+    case VertexLayout::Quads:
+        geometry = new QSGGeometry(quadAttributes(), 0);
+        geometry->setDrawingMode(GL_TRIANGLES);
+        break;
+    default:
+        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(strip_mode);
+        break;
+    }
+    return geometry;
+}
+
 
 class FillNode : public QSGGeometryNode
 {
 public:
     FillNode() {
-        QSGGeometry* geometry;
-        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
-        geometry->setDrawingMode(GL_TRIANGLE_STRIP);
-        QSGMaterial* material;
-        material = new XYFillMaterial;
-        setGeometry(geometry);
+        setGeometry(createGeometry(m_layout, GL_TRIANGLE_STRIP, GL_TRIANGLES));
         setFlag(QSGNode::OwnsGeometry);
-        setMaterial(material);
+        setMaterial(new XYFillMaterial);
         setFlag(QSGNode::OwnsMaterial);
     }
     ~FillNode() override = default;
     bool isSubtreeBlocked() const override {
         return m_blocked;
     }
+    // Switch between triangle strip, indexed triangles for ring buffer data and pulled vertices
+    void setLayout(VertexLayout layout) {
+        setGeometry(createGeometry(layout, GL_TRIANGLE_STRIP, GL_TRIANGLES));
+        if ((layout == VertexLayout::Pulling) != (m_layout == VertexLayout::Pulling)) {
+            setMaterial(new XYFillMaterial(layout == VertexLayout::Pulling));
+        }
+        m_layout = layout;
+        m_data_valid = false;
+    }
     bool m_blocked = false;
     bool m_data_valid = false;
+    VertexLayout m_layout = VertexLayout::Strip;
 };
 
 
@@ -462,22 +879,29 @@ class LineNode : public QSGGeometryNode
 {
 public:
     LineNode() {
-        QSGGeometry* geometry;
-        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
-        geometry->setDrawingMode(GL_LINE_STRIP);
-        QSGMaterial* material;
-        material = new XYLineMaterial;
-        setGeometry(geometry);
+        setGeometry(createGeometry(m_layout, GL_LINE_STRIP, GL_LINES));
         setFlag(QSGNode::OwnsGeometry);
-        setMaterial(material);
+        setMaterial(new XYLineMaterial);
         setFlag(QSGNode::OwnsMaterial);
     }
     ~LineNode() override = default;
     bool isSubtreeBlocked() const override {
         return m_blocked;
     }
+    // Switch between line strip, indexed line segments for ring buffer data and pulled vertices
+    void setLayout(VertexLayout layout) {
+        QSGGeometry* geometry = createGeometry(layout, GL_LINE_STRIP, GL_LINES);
+        geometry->setLineWidth(this->geometry()->lineWidth());
+        setGeometry(geometry);
+        if ((layout == VertexLayout::Pulling) != (m_layout == VertexLayout::Pulling)) {
+            setMaterial(new XYLineMaterial(layout == VertexLayout::Pulling));
+        }
+        m_layout = layout;
+        m_data_valid = false;
+    }
     bool m_blocked = false;
     bool m_data_valid = false;
+    VertexLayout m_layout = VertexLayout::Strip;
 };
 
 
@@ -485,22 +909,52 @@ class MarkerNode : public QSGGeometryNode
 {
 public:
     MarkerNode() {
-        QSGGeometry* geometry;
-        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
-        geometry->setDrawingMode(GL_POINTS);
-        QSGMaterial* material;
-        material = new XYMarkerMaterial;
-        setGeometry(geometry);
+        setGeometry(createGeometry(m_layout, GL_POINTS, GL_POINTS));
         setFlag(QSGNode::OwnsGeometry);
-        setMaterial(material);
+        setMaterial(new XYMarkerMaterial);
         setFlag(QSGNode::OwnsMaterial);
     }
     ~MarkerNode() override = default;
     bool isSubtreeBlocked() const override {
         return m_blocked;
     }
+    // Switch between point sprites and quads with pulled points, ring buffer markers are not indexed
+    void setLayout(VertexLayout layout) {
+        setGeometry(createGeometry(layout, GL_POINTS, GL_POINTS));
+        if ((layout == VertexLayout::Quads) != (m_layout == VertexLayout::Quads)) {
+            setMaterial(new XYMarkerMaterial(layout == VertexLayout::Quads));
+        }
+        m_layout = layout;
+        m_data_valid = false;
+    }
     bool m_blocked = false;
     bool m_data_valid = false;
+    VertexLayout m_layout = VertexLayout::Strip;
+};
+
+
+// Point texture of full data shared by the plots of a data source, updated in place by the changes since change_count
+struct SharedPointTexture {
+    QSGDataTexture<float> texture;
+    qint64 change_count = -1;
+};
+
+// Root node, holds the point texture used by all layers and owns the marker attribute textures.
+// The point texture of full data is shared with other plots of the same data source, decimated points are kept
+// in a private texture which is refilled when the view changes.
+class XYPlotNode : public QSGNode
+{
+public:
+    XYPlotNode() = default;
+    ~XYPlotNode() override = default;
+    QSGDataTexture<float>* m_points = nullptr;
+    std::shared_ptr<SharedPointTexture> m_shared_points;
+    QSGDataTexture<float> m_decimated_points;
+    QSGDataTexture<float> m_sizes;
+    QSGDataTexture<float> m_colors;
+    QSGDataTexture<float> m_colormap;
+    bool m_points_valid = false;
+    bool m_attributes_valid = false;
 };
 
 
@@ -528,8 +982,146 @@ static void paintPolygon(QImage& img, unsigned int segments, bool border) {
     }
 }
 
+// Connect ring buffer point p to the following point q, q < 0 leaves the segment after p empty
+static void setRingSegment(QSGGeometry* geometry, int p, int q)
+{
+    quint32* indices = geometry->indexDataAsUInt();
+    const auto a = static_cast<quint32>(p);
+    const auto b = static_cast<quint32>((q < 0) ? p : q);
+    if (geometry->drawingMode() == GL_TRIANGLES) {
+        // fill quad between the (x, 0), (x, y) vertex pairs of both points
+        const quint32 quad[6] = {2*a, 2*a+1, 2*b, 2*b, 2*a+1, 2*b+1};
+        std::copy(quad, quad + 6, indices + 6*p);
+    } else {
+        indices[2*p+0] = a;
+        indices[2*p+1] = b;
+    }
+}
+
+// Copy xy points to fill strip vertices (x, 0), (x, y)
+template<typename T>
+static void copyFillVertices(const T* src, int num_points, float* dst)
+{
+    parallelFor(num_points, ParallelGrainSize / 2, [=](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            dst[4*i+0] = static_cast<float>(src[2*i+0]);
+            dst[4*i+1] = 0.;
+            dst[4*i+2] = static_cast<float>(src[2*i+0]);
+            dst[4*i+3] = static_cast<float>(src[2*i+1]);
+        }
+    });
+}
+
+// Copy xy points to line or marker vertices
+template<typename T>
+static void copyPointVertices(const T* src, int num_points, float* dst)
+{
+    parallelFor(int64_t(num_points) * 2, ParallelGrainSize, [=](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            dst[i] = static_cast<float>(src[i]);
+        }
+    });
+}
+
+// Double precision data uses the vectorized conversion kernels
+static void copyFillVertices(const double* src, int num_points, float* dst)
+{
+    convertFillPoints(src, num_points, dst);
+}
+
+static void copyPointVertices(const double* src, int num_points, float* dst)
+{
+    convertToFloat(src, num_points*2, dst);
+}
+
+// Points per row of the point texture, MaxPulledPoints fill 4096 rows (the smallest maximum texture size of
+// OpenGL 3), marker quad indices are exact floats up to MaxPulledPoints
+static const int PointTextureWidth = 4096;
+static const int MaxPulledPoints = 1 << 24;
+
+// Copy xy points to a two component float texture, rows of PointTextureWidth points
+template<typename T>
+static void copyPointTexture(const T* src, int num_points, QSGDataTexture<float>& texture)
+{
+    const int height = std::max((num_points + PointTextureWidth - 1) / PointTextureWidth, 1);
+    float* dst = texture.allocateData2D(PointTextureWidth, height, 2);
+    copyPointVertices(src, num_points, dst);
+    std::fill(dst + 2*num_points, dst + 2*PointTextureWidth*height, 0.f);
+    texture.commitData();
+}
+
+// Upload the points [first, last) of the point texture, whole rows if they span more than one row
+template<typename T>
+static bool uploadPointRange(const T* src, int num_points, int first, int last, QSGDataTexture<float>& texture)
+{
+    const int first_row = first / PointTextureWidth;
+    const int last_row = (last - 1) / PointTextureWidth;
+    if (first_row == last_row) {
+        std::vector<float> buffer(2 * static_cast<size_t>(last - first));
+        copyPointVertices(src + 2*static_cast<size_t>(first), last - first, buffer.data());
+        return texture.uploadRegion(buffer.data(), last - first, first % PointTextureWidth, first_row, last - first, 1);
+    }
+    const int begin = first_row * PointTextureWidth;
+    const int end = std::min((last_row + 1) * PointTextureWidth, num_points);
+    std::vector<float> buffer(2 * static_cast<size_t>(last_row - first_row + 1) * PointTextureWidth, 0.f);
+    copyPointVertices(src + 2*static_cast<size_t>(begin), end - begin, buffer.data());
+    return texture.uploadRegion(buffer.data(), PointTextureWidth, 0, first_row, PointTextureWidth, last_row - first_row + 1);
+}
+
+// Update the point texture for the changed region of xy data (elements in x), the whole texture is copied
+// if the region covers all data or the texture has no storage of the same size yet
+template<typename T>
+static void updatePointTexture(const T* src, int num_points, const QRegion& region, bool full, QSGDataTexture<float>& texture)
+{
+    const int height = std::max((num_points + PointTextureWidth - 1) / PointTextureWidth, 1);
+    bool uploaded = !full && texture.getDim(0) == PointTextureWidth && texture.getDim(1) == height;
+    for (const QRect& rect : region) {
+        const int first = rect.x() / 2;
+        const int last = std::min((rect.x() + rect.width() + 1) / 2, num_points);
+        uploaded = uploaded && (first >= last || uploadPointRange(src, num_points, first, last, texture));
+    }
+    if (!uploaded) {
+        copyPointTexture(src, num_points, texture);
+    }
+}
+
+// Copy per-point values with num_components each to a float texture with the layout of the point texture,
+// points without values are set to zero
+template<typename T>
+static void copyAttributeTexture(const T* src, int num_values, int num_components, double scale,
+                                 int num_points, QSGDataTexture<float>& texture)
+{
+    const int height = std::max((num_points + PointTextureWidth - 1) / PointTextureWidth, 1);
+    float* dst = texture.allocateData2D(PointTextureWidth, height, num_components);
+    const int n = std::min(num_values, num_points) * num_components;
+    for (int i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i] * scale);
+    }
+    std::fill(dst + n, dst + num_components*PointTextureWidth*height, 0.f);
+    texture.commitData();
+}
+
+// Point index and corner of two triangles per marker quad
+static void setQuadVertices(QSGGeometry* geometry)
+{
+    auto* dst = static_cast<float*>(geometry->vertexData());
+    for (int i = 0; i < geometry->vertexCount(); ++i) {
+        dst[2*i+0] = static_cast<float>(i / 6);
+        dst[2*i+1] = static_cast<float>(i % 6);
+    }
+    RenderStats::addVertices(geometry->vertexCount());
+}
+
+// Vertices of the pulling layout carry no data, shaders use gl_VertexID
+static void setVertexIndices(QSGGeometry* geometry)
+{
+    std::memset(geometry->vertexData(), 0, static_cast<size_t>(geometry->vertexCount()) * sizeof(quint8));
+    RenderStats::addVertices(geometry->vertexCount());
+}
+
 QSGNode *XYPlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData *)
 {
+    PaintScope paint_scope(m_render_stats, this);
     FillNode* n_fill;
     LineNode* n_line;
     MarkerNode* n_marker;
@@ -542,8 +1134,11 @@ QSGNode *XYPlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData *)
     QSGNode::DirtyState dirty_state = QSGNode::DirtyMaterial;
 
     if (n == nullptr) {
-        n = new QSGNode;
+        n = new XYPlotNode;
+        // textures of a new root node are empty
+        m_new_colormap = true;
     }
+    auto* n_xy = static_cast<XYPlotNode*>(n);
 
     if (m_source == nullptr) {
         // remove child nodes if there is no data source
@@ -577,12 +1172,6 @@ QSGNode *XYPlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData *)
     n_fill = static_cast<FillNode*>(n->childAtIndex(0));
     n_line = static_cast<LineNode*>(n->childAtIndex(1));
     n_marker = static_cast<MarkerNode*>(n->childAtIndex(2));
-    fgeometry = n_fill->geometry();
-    lgeometry = n_line->geometry();
-    mgeometry = n_marker->geometry();
-    fmaterial = static_cast<XYFillMaterial*>(n_fill->material());
-    lmaterial = static_cast<XYLineMaterial*>(n_line->material());
-    mmaterial = static_cast<XYMarkerMaterial*>(n_marker->material());
 
     // check if fill, line or markers were switched on or off
     if (n_fill->m_blocked == m_fill || n_line->m_blocked == m_line || n_marker->m_blocked == m_marker) {
@@ -598,6 +1187,56 @@ QSGNode *XYPlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData *)
     double xrange = m_view_rect.width();
     double yrange = m_view_rect.height();
 
+    // decimate data to the visible pixel columns, view and size changes require a new decimation
+    if (m_decimation) {
+        if (m_new_source || m_new_data || m_new_geometry) {
+            const qreal dpr = (window() != nullptr) ? window()->effectiveDevicePixelRatio() : 1.;
+            const auto num_columns = static_cast<int>(std::ceil(width() * dpr));
+            const MinMaxPyramid& pyramid = m_source->minMaxPyramid();
+            const MinMaxPyramid* p_pyramid = pyramid.isEmpty() ? nullptr : &pyramid;
+            m_decimated.clear();
+            m_source->visitData([&](const auto* src) {
+                if (m_source->streaming()) {
+                    decimateMinMaxRing(src, num_data_points, m_source->streamOffset() / 2, m_source->streamLength() / 2,
+                                       xmin, xrange, num_columns, p_pyramid, m_decimated);
+                } else {
+                    decimateMinMax(src, 0, num_data_points, xmin, xrange, num_columns, p_pyramid, m_decimated);
+                }
+            });
+            m_new_data = true;
+        }
+        num_data_points = static_cast<int>(m_decimated.size() / 2);
+    } else if (!m_decimated.empty()) {
+        m_decimated = std::vector<double>();
+    }
+    m_new_geometry = false;
+
+    // ring buffer data is drawn as indexed segments, appended points only update their own vertices
+    const bool ring = !m_decimation && m_source->streaming() && m_source->dataDimensions() == 1;
+    // with vertex pulling all layers fetch points from one texture, vertex buffers only hold static indices
+    const bool pulling = m_vertex_pulling && !ring && num_data_points <= MaxPulledPoints;
+    const VertexLayout layout = pulling ? VertexLayout::Pulling : (ring ? VertexLayout::Ring : VertexLayout::Strip);
+    const VertexLayout marker_layout = pulling ? VertexLayout::Quads : VertexLayout::Strip;
+    if (n_fill->m_layout != layout) {
+        n_fill->setLayout(layout);
+    }
+    if (n_line->m_layout != layout) {
+        n_line->setLayout(layout);
+    }
+    if (n_marker->m_layout != marker_layout) {
+        n_marker->setLayout(marker_layout);
+    }
+
+    fgeometry = n_fill->geometry();
+    lgeometry = n_line->geometry();
+    mgeometry = n_marker->geometry();
+    fmaterial = static_cast<XYFillMaterial*>(n_fill->material());
+    lmaterial = static_cast<XYLineMaterial*>(n_line->material());
+    mmaterial = static_cast<XYMarkerMaterial*>(n_marker->material());
+
+    // markers of a partially filled ring buffer are limited to valid points
+    const int num_marker_points = ring ? std::min(m_source->streamLength() / 2, num_data_points) : num_data_points;
+
     if (m_fill) {
         // update fill material parameters
         fmaterial->m_size.setWidth(width());
@@ -606,13 +1245,19 @@ QSGNode *XYPlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData *)
         fmaterial->m_scale.setHeight(1. / yrange);
         fmaterial->m_offset.setX(xmin);
         fmaterial->m_offset.setY(ymin);
+        fmaterial->m_logy = m_logy;
         fmaterial->m_color = m_fillcolor;
         fmaterial->setFlag(QSGMaterial::Blending, m_fillcolor.alphaF() != 1.);
 
         // reallocate geometry if number of points changed
-        if (fgeometry->vertexCount() != (2*num_data_points)) {
-            fgeometry->allocate(2*num_data_points);
-            m_new_data = true;
+        const int num_indices = (layout == VertexLayout::Ring) ? 6*num_data_points : 0;
+        if (fgeometry->vertexCount() != (2*num_data_points) || fgeometry->indexCount() != num_indices) {
+            fgeometry->allocate(2*num_data_points, num_indices);
+            n_fill->m_data_valid = false;
+            if (pulling) {
+                setVertexIndices(fgeometry);
+                dirty_state |= QSGNode::DirtyGeometry;
+            }
         }
     }
 
@@ -624,22 +1269,28 @@ QSGNode *XYPlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData *)
         lmaterial->m_scale.setHeight(1. / yrange);
         lmaterial->m_offset.setX(xmin);
         lmaterial->m_offset.setY(ymin);
+        lmaterial->m_logy = m_logy;
         lmaterial->m_color = m_linecolor;
         lmaterial->setFlag(QSGMaterial::Blending, m_linecolor.alphaF() != 1.);
         lgeometry->setLineWidth(static_cast<float>(m_linewidth));
 
         // reallocate geometry if number of points changed
-        if (lgeometry->vertexCount() != num_data_points) {
-            lgeometry->allocate(num_data_points);
-            m_new_data = true;
+        const int num_indices = (layout == VertexLayout::Ring) ? 2*num_data_points : 0;
+        if (lgeometry->vertexCount() != num_data_points || lgeometry->indexCount() != num_indices) {
+            lgeometry->allocate(num_data_points, num_indices);
+            n_line->m_data_valid = false;
+            if (pulling) {
+                setVertexIndices(lgeometry);
+                dirty_state |= QSGNode::DirtyGeometry;
+            }
         }
     }
 
     if (m_marker) {
-        // update marker image
-        if (mmaterial->m_markersize != m_markersize ||
+        // update marker image, quad markers are computed in the shader
+        if (!pulling && (mmaterial->m_markersize != m_markersize ||
                 mmaterial->m_markersegments != m_markersegments ||
-                mmaterial->m_markerborder != m_markerborder) {
+                mmaterial->m_markerborder != m_markerborder)) {
             auto image_size = static_cast<int>(std::ceil(m_markersize));
             uint8_t* data = mmaterial->m_markerimage.allocateData2D(image_size, image_size, 4);
             QImage qimage(data, image_size, image_size, QImage::Format_ARGB32);
@@ -655,73 +1306,229 @@ QSGNode *XYPlot::updatePaintNode(QSGNode *n, QQuickItem::UpdatePaintNodeData *)
         mmaterial->m_scale.setHeight(1. / yrange);
         mmaterial->m_offset.setX(xmin);
         mmaterial->m_offset.setY(ymin);
+        mmaterial->m_logy = m_logy;
         mmaterial->m_markersegments = m_markersegments;
         mmaterial->m_markerborder = m_markerborder;
         mmaterial->m_markercolor = m_markercolor;
         mmaterial->m_markersize = m_markersize;
         mmaterial->setFlag(QSGMaterial::Blending);
 
-        // reallocate geometry if number of points changed
-        if (mgeometry->vertexCount() != num_data_points) {
-            mgeometry->allocate(num_data_points);
-            m_new_data = true;
+        // reallocate geometry if number of points changed, quad markers have six vertices each
+        const int num_marker_vertices = pulling ? 6*num_marker_points : num_marker_points;
+        if (mgeometry->vertexCount() != num_marker_vertices) {
+            mgeometry->allocate(num_marker_vertices);
+            n_marker->m_data_valid = false;
+            if (pulling) {
+                setQuadVertices(mgeometry);
+                dirty_state |= QSGNode::DirtyGeometry;
+            }
+        }
+
+        // per-point sizes and colours of quad markers, decimated points have no attributes
+        const bool attributes = pulling && !m_decimation;
+        mmaterial->m_sizes = (attributes && m_size_source != nullptr) ? &n_xy->m_sizes : nullptr;
+        mmaterial->m_colors = (attributes && m_color_source != nullptr) ? &n_xy->m_colors : nullptr;
+
+        // scalar colour values are mapped through the colormap with the same margins as ColormappedImage
+        const bool colormapped = mmaterial->m_colors != nullptr && !m_markercolormap.isEmpty();
+        if (colormapped && m_new_colormap) {
+            updateColormapTexture(n_xy->m_colormap, m_markercolormap);
+            m_new_colormap = false;
+        }
+        mmaterial->m_colormap = colormapped ? &n_xy->m_colormap : nullptr;
+        if (colormapped) {
+            const double cmap_margin = .5 / n_xy->m_colormap.getDim(0);
+            const double amplitude = (1. - 2.*cmap_margin) / (m_markercolor_max - m_markercolor_min);
+            mmaterial->m_cmap_amplitude = amplitude;
+            mmaterial->m_cmap_offset = (cmap_margin / amplitude) - m_markercolor_min;
         }
     }
 
+    // ring buffer data can be updated incrementally if only points were appended since the last update
+    int num_appended = -1;
+    if (ring && !m_new_source && m_stream_revision == m_source->streamRevision()) {
+        const qint64 appended = m_source->streamAppended() - m_stream_appended;
+        if (appended >= 0 && appended <= m_source->dataWidth()) {
+            num_appended = static_cast<int>((appended + 1) / 2);
+        }
+    }
+    m_stream_revision = m_source->streamRevision();
+    m_stream_appended = m_source->streamAppended();
+
     // update geometry if new data is available
-    if (m_new_source || m_new_data) {
+    if (m_new_source) {
+        n_xy->m_shared_points.reset();
+    }
+    if (m_new_source || (m_new_data && num_appended < 0)) {
         n_fill->m_data_valid = false;
         n_line->m_data_valid = false;
         n_marker->m_data_valid = false;
-        m_new_source = false;
-        m_new_data = false;
+        n_xy->m_points_valid = false;
+        n_xy->m_attributes_valid = false;
+    }
+    if (m_new_marker_attributes) {
+        n_xy->m_attributes_valid = false;
+        m_new_marker_attributes = false;
     }
+    m_new_source = false;
+    m_new_data = false;
+
+    const auto copyVertices = [&](const auto* src) {
+        QMLPLOTTING_TRACE_SCOPE("XYPlot::copyVertices");
+        if (m_fill && !n_fill->m_data_valid) {
+            copyFillVertices(src, num_data_points, static_cast<float*>(fgeometry->vertexData()));
+            RenderStats::addVertices(2 * num_data_points);
+            dirty_state |= QSGNode::DirtyGeometry;
+            n_fill->m_data_valid = !ring;
+        }
+        if (m_line && !n_line->m_data_valid) {
+            copyPointVertices(src, num_data_points, static_cast<float*>(lgeometry->vertexData()));
+            RenderStats::addVertices(num_data_points);
+            dirty_state |= QSGNode::DirtyGeometry;
+            n_line->m_data_valid = !ring;
+        }
+        if (m_marker && !n_marker->m_data_valid) {
+            copyPointVertices(src, num_marker_points, static_cast<float*>(mgeometry->vertexData()));
+            RenderStats::addVertices(num_marker_points);
+            dirty_state |= QSGNode::DirtyGeometry;
+            n_marker->m_data_valid = true;
+        }
+    };
+
+    const auto updateRing = [&](const auto* src) {
+        const int start = m_source->streamOffset() / 2;
+        const int length = std::min(m_source->streamLength() / 2, num_data_points);
+        const auto ringPos = [start, num_data_points](int i) { return (start + i) % num_data_points; };
+        const int first_new = std::max(length - std::max(num_appended, 0), 0);
+        QMLPLOTTING_TRACE_SCOPE("XYPlot::updateRing");
+
+        // vertices of invalid nodes were converted already, connect all points in logical order
+        if (m_fill && !n_fill->m_data_valid) {
+            for (int p = 0; p < num_data_points; ++p) {
+                setRingSegment(fgeometry, p, -1);
+            }
+            for (int i = 1; i < length; ++i) {
+                setRingSegment(fgeometry, ringPos(i-1), ringPos(i));
+            }
+            n_fill->m_data_valid = true;
+        } else if (m_fill && first_new < length) {
+            auto* fdst = static_cast<float*>(fgeometry->vertexData());
+            for (int i = first_new; i < length; ++i) {
+                const int p = ringPos(i);
+                copyFillVertices(src + 2*p, 1, fdst + 4*p);
+                setRingSegment(fgeometry, p, -1);
+                if (i > 0) {
+                    setRingSegment(fgeometry, ringPos(i-1), p);
+                }
+            }
+            RenderStats::addVertices(2 * (length - first_new));
+            dirty_state |= QSGNode::DirtyGeometry;
+        }
 
-    auto* src = reinterpret_cast<double*>(m_source->data());
+        if (m_line && !n_line->m_data_valid) {
+            for (int p = 0; p < num_data_points; ++p) {
+                setRingSegment(lgeometry, p, -1);
+            }
+            for (int i = 1; i < length; ++i) {
+                setRingSegment(lgeometry, ringPos(i-1), ringPos(i));
+            }
+            n_line->m_data_valid = true;
+        } else if (m_line && first_new < length) {
+            auto* ldst = static_cast<float*>(lgeometry->vertexData());
+            for (int i = first_new; i < length; ++i) {
+                const int p = ringPos(i);
+                copyPointVertices(src + 2*p, 1, ldst + 2*p);
+                setRingSegment(lgeometry, p, -1);
+                if (i > 0) {
+                    setRingSegment(lgeometry, ringPos(i-1), p);
+                }
+            }
+            RenderStats::addVertices(length - first_new);
+            dirty_state |= QSGNode::DirtyGeometry;
+        }
 
-    if (m_fill && !n_fill->m_data_valid) {
-        auto* fdst = static_cast<float*>(fgeometry->vertexData());
-        for (int i = 0; i < num_data_points; ++i) {
-            fdst[4*i+0] = static_cast<float>(src[2*i+0]);
-            fdst[4*i+1] = 0.;
-            fdst[4*i+2] = static_cast<float>(src[2*i+0]);
-            fdst[4*i+3] = static_cast<float>(src[2*i+1]);
+        // markers of a full ring buffer are stored at ring positions
+        if (m_marker && n_marker->m_data_valid && first_new < length && length == num_data_points) {
+            auto* mdst = static_cast<float*>(mgeometry->vertexData());
+            for (int i = first_new; i < length; ++i) {
+                const int p = ringPos(i);
+                copyPointVertices(src + 2*p, 1, mdst + 2*p);
+            }
+            RenderStats::addVertices(length - first_new);
+            dirty_state |= QSGNode::DirtyGeometry;
         }
-        dirty_state |= QSGNode::DirtyGeometry;
-        n_fill->m_data_valid = true;
+    };
+
+    if (!pulling && n_xy->m_points != nullptr) {
+        // release the point texture, possibly shared with other plots
+        n_xy->m_points = nullptr;
+        n_xy->m_shared_points.reset();
+        n_xy->m_points_valid = false;
     }
 
-    if (m_line && !n_line->m_data_valid) {
-        auto* ldst = static_cast<float*>(lgeometry->vertexData());
-        if (m_logy) {
-            for (int i = 0; i < num_data_points; ++i) {
-                ldst[i*2 + 0] = static_cast<float>(src[i*2 + 0]);
-                ldst[i*2 + 1] = static_cast<float>(std::log10(src[i*2 + 1]));
+    if (pulling) {
+        // vertex data is static, only the point texture is updated
+        if (m_decimation) {
+            // decimation depends on the view, the private texture is refilled
+            if (!n_xy->m_points_valid || n_xy->m_points != &n_xy->m_decimated_points) {
+                copyPointTexture(m_decimated.data(), num_data_points, n_xy->m_decimated_points);
+                n_xy->m_points = &n_xy->m_decimated_points;
+                n_xy->m_points_valid = true;
             }
         } else {
-            for (int i = 0; i < num_data_points*2; ++i) {
-                ldst[i] = static_cast<float>(src[i]);
+            // the first plot rendered after a change updates the shared texture, partial commits upload their region
+            if (!n_xy->m_shared_points) {
+                bool created = false;
+                const SharedResources::Key key = {0, SharedResources::XYPointTexture, 0};
+                n_xy->m_shared_points = m_source->sharedResources().acquire<SharedPointTexture>(key, created, [] {
+                    return new SharedPointTexture();
+                });
             }
+            SharedPointTexture& shared = *n_xy->m_shared_points;
+            if (shared.change_count != m_source->changeCount()) {
+                const QRegion region = m_source->changedRegion(shared.change_count);
+                const bool full = shared.change_count < 0 || region == QRegion(0, 0, m_source->dataWidth(), 1);
+                m_source->visitData([&](const auto* src) {
+                    updatePointTexture(src, num_data_points, region, full, shared.texture);
+                });
+                shared.change_count = m_source->changeCount();
+            }
+            n_xy->m_points = &shared.texture;
         }
-        dirty_state |= QSGNode::DirtyGeometry;
-        n_line->m_data_valid = true;
-    }
-
-    if (m_marker && !n_marker->m_data_valid) {
-        auto* mdst = static_cast<float*>(mgeometry->vertexData());
-        if (m_logy) {
-            for (int i = 0; i < num_data_points; ++i) {
-                mdst[i*2 + 0] = static_cast<float>(src[i*2 + 0]);
-                mdst[i*2 + 1] = static_cast<float>(std::log10(src[i*2 + 1]));
+        // marker sizes in pixels, one per point, colours as RGBA tuples, integer colours are normalized
+        if (m_marker && !m_decimation && !n_xy->m_attributes_valid) {
+            if (m_size_source != nullptr) {
+                const int num_values = m_size_source->dataWidth();
+                m_size_source->visitData([&](const auto* src) {
+                    copyAttributeTexture(src, num_values, 1, 1., num_marker_points, n_xy->m_sizes);
+                });
             }
-        } else {
-            for (int i = 0; i < num_data_points*2; ++i) {
-                mdst[i] = static_cast<float>(src[i]);
+            if (m_color_source != nullptr) {
+                // colormapped values are kept in data units, the colormap range applies to them
+                const int num_components = m_markercolormap.isEmpty() ? 4 : 1;
+                const int num_values = m_color_source->dataWidth() / num_components;
+                const double scale = m_markercolormap.isEmpty() ? m_color_source->valueScale() : 1.;
+                m_color_source->visitData([&](const auto* src) {
+                    copyAttributeTexture(src, num_values, num_components, scale, num_marker_points, n_xy->m_colors);
+                });
             }
+            n_xy->m_attributes_valid = true;
         }
-        dirty_state |= QSGNode::DirtyGeometry;
-        n_marker->m_data_valid = true;
+    } else if (m_decimation) {
+        copyVertices(m_decimated.data());
+    } else if (ring) {
+        m_source->visitData([&](const auto* src) {
+            copyVertices(src);
+            if (num_data_points > 0) {
+                updateRing(src);
+            }
+        });
+    } else {
+        m_source->visitData(copyVertices);
     }
+    fmaterial->m_points = n_xy->m_points;
+    lmaterial->m_points = n_xy->m_points;
+    mmaterial->m_points = n_xy->m_points;
 
     n->markDirty(dirty_state);
     n_fill->markDirty(dirty_state);
@@ -2,6 +2,7 @@
 #define XYPLOT_H
 
 #include "dataclient.h"
+#include <vector>
 
 class XYPlot : public DataClient
 {
@@ -18,6 +19,13 @@ class XYPlot : public DataClient
     Q_PROPERTY(QColor markerColor MEMBER m_markercolor WRITE setMarkerColor NOTIFY markerColorChanged)
     Q_PROPERTY(bool markerBorder MEMBER m_markerborder WRITE setMarkerBorder NOTIFY markerBorderChanged)
     Q_PROPERTY(bool logY MEMBER m_logy WRITE setLogY NOTIFY logYChanged)
+    Q_PROPERTY(bool decimationEnabled MEMBER m_decimation WRITE setDecimationEnabled NOTIFY decimationEnabledChanged)
+    Q_PROPERTY(bool vertexPulling MEMBER m_vertex_pulling WRITE setVertexPulling NOTIFY vertexPullingChanged)
+    Q_PROPERTY(QQuickItem* markerSizeSource READ markerSizeSource WRITE setMarkerSizeSource NOTIFY markerSizeSourceChanged)
+    Q_PROPERTY(QQuickItem* markerColorSource READ markerColorSource WRITE setMarkerColorSource NOTIFY markerColorSourceChanged)
+    Q_PROPERTY(QString markerColormap MEMBER m_markercolormap WRITE setMarkerColormap NOTIFY markerColormapChanged)
+    Q_PROPERTY(double markerColorMin MEMBER m_markercolor_min WRITE setMarkerColorMin NOTIFY markerColorMinChanged)
+    Q_PROPERTY(double markerColorMax MEMBER m_markercolor_max WRITE setMarkerColorMax NOTIFY markerColorMaxChanged)
 
 public:
     explicit XYPlot(QQuickItem *parent = nullptr);
@@ -35,6 +43,17 @@ public:
     void setMarkerColor(const QColor& color);
     void setMarkerBorder(bool enabled);
     void setLogY(bool enabled);
+    void setDecimationEnabled(bool enabled);
+    void setVertexPulling(bool enabled);
+    // Per-point marker sizes (1D, one value per point) and colours (1D, RGBA per point), quad markers only
+    QQuickItem* markerSizeSource() const {return m_size_source;}
+    QQuickItem* markerColorSource() const {return m_color_source;}
+    void setMarkerSizeSource(QQuickItem* item);
+    void setMarkerColorSource(QQuickItem* item);
+    // With a colormap the colour source holds one scalar per point, mapped from markerColorMin..markerColorMax
+    void setMarkerColormap(const QString& colormap);
+    void setMarkerColorMin(double value);
+    void setMarkerColorMax(double value);
 
 signals:
     void viewRectChanged(const QRectF& viewrect);
@@ -49,9 +68,17 @@ signals:
     void markerColorChanged(const QColor&);
     void markerBorderChanged(bool);
     void logYChanged(bool);
+    void decimationEnabledChanged(bool);
+    void vertexPullingChanged(bool);
+    void markerSizeSourceChanged(QQuickItem* item);
+    void markerColorSourceChanged(QQuickItem* item);
+    void markerColormapChanged(const QString& colormap);
+    void markerColorMinChanged(double value);
+    void markerColorMaxChanged(double value);
 
 protected:
     QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* updatePaintNodeData) override;
+    Q_INVOKABLE void markerAttributesChanged();
 
 private:
     QRectF m_view_rect = {0, 0, 1, 1};
@@ -66,6 +93,19 @@ private:
     QColor m_markercolor = {0, 0, 0};
     bool m_markerborder = false;
     bool m_logy = false;
+    bool m_decimation = false;
+    bool m_vertex_pulling = false;
+    DataSource* m_size_source = nullptr;
+    DataSource* m_color_source = nullptr;
+    bool m_new_marker_attributes = false;
+    QString m_markercolormap;
+    double m_markercolor_min = 0.;
+    double m_markercolor_max = 1.;
+    bool m_new_colormap = true;
+    std::vector<double> m_decimated;
+    // ring buffer state of the last geometry update
+    int m_stream_revision = -1;
+    qint64 m_stream_appended = 0;
 };
 
 #endif // XYPLOT_H
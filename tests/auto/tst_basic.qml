@@ -16,14 +16,277 @@ QmlPlotting.PlotGroup {
         QmlPlotting.XYPlot {
             id: xyPlot
             dataSource: QmlPlotting.DataSource {}
+        },
+        QmlPlotting.MultiTracePlot {
+            id: multiTracePlot
+            dataSource: QmlPlotting.DataSource {}
         }
     ]
 
+    // Opaque white scene above all plot items for pixel tests, the plot item is its only child
+    function createScene(item) {
+        return Qt.createQmlObject("import QtQuick 2.7; import QmlPlotting 2.0; Rectangle { anchors.fill: parent; z: 1; color: \"white\"; "
+                                  + item + " }", plotGroup);
+    }
+
     TestCase {
         name: "XYPlot"
         function test_setTestData() {
             xyPlot.dataSource.setTestData1D();
         }
+        function test_decimation() {
+            xyPlot.decimationEnabled = true;
+            xyPlot.dataSource.setTestData1D();
+            compare(xyPlot.decimationEnabled, true);
+            xyPlot.decimationEnabled = false;
+        }
+        function test_logY() {
+            var scene = createScene("XYPlot { anchors.fill: parent; lineEnabled: false; markerEnabled: false; fillEnabled: true; fillColor: \"red\"; "
+                                    + "viewRect: Qt.rect(0, 0, 1, 2); dataSource: DataSource {} }");
+            var plot = scene.children[0];
+            verify(plot.dataSource.copyArray1D(new Float64Array([0, 10, 1, 10]).buffer, 4, QmlPlotting.DataSource.Float64));
+            // linear y = 10 fills the whole view
+            var image = grabImage(scene);
+            compare(image.green(256, 64), 0);
+            compare(image.green(256, 448), 0);
+            // log10(10) = 1 fills the lower half of view y in [0, 2]
+            plot.logY = true;
+            image = grabImage(scene);
+            compare(image.green(256, 64), 255);
+            compare(image.red(256, 448), 255);
+            compare(image.green(256, 448), 0);
+            // baseline and non-positive values are clamped to the lower view border, nothing is filled
+            verify(plot.dataSource.copyArray1D(new Float64Array([0, -1, 1, 0]).buffer, 4, QmlPlotting.DataSource.Float64));
+            image = grabImage(scene);
+            compare(image.green(256, 448), 255);
+            compare(image.green(256, 508), 255);
+            scene.destroy();
+        }
+        function test_vertexPulling() {
+            var scene = createScene("XYPlot { anchors.fill: parent; markerEnabled: false; fillEnabled: true; fillColor: \"lightblue\"; "
+                                    + "viewRect: Qt.rect(-1, 0, 2, 1); renderStatsEnabled: true; dataSource: DataSource {} }");
+            var plot = scene.children[0];
+            var n = 512;
+            var xy = new Float64Array(2*n);
+            for (var i = 0; i < n; ++i) {
+                xy[2*i] = 2 * i / (n - 1) - 1;
+                xy[2*i+1] = .5 + .4 * Math.sin(.05 * i);
+            }
+            verify(plot.dataSource.copyArray1D(xy.buffer, 2*n, QmlPlotting.DataSource.Float64));
+            var reference = grabImage(scene);
+            // fill has two vertices per point, line one
+            compare(plot.verticesGenerated, 3*n);
+
+            // pulled points cover the same pixels, vertex buffers only hold indices
+            plot.vertexPulling = true;
+            verify(grabImage(scene).equals(reference));
+            var uploaded = plot.textureBytesUploaded;
+            verify(plot.dataSource.copyArray1D(xy.buffer, 2*n, QmlPlotting.DataSource.Float64));
+            verify(grabImage(scene).equals(reference));
+            compare(plot.verticesGenerated, 0);
+            // one row of 4096 xy points
+            compare(plot.textureBytesUploaded - uploaded, 4096 * 2 * 4);
+
+            // ring buffers fall back to indexed segments without a point texture
+            plot.vertexPulling = false;
+            plot.dataSource.allocateStream1D(2*n);
+            verify(plot.dataSource.append(xy.buffer));
+            verify(plot.dataSource.append(xy.buffer.slice(0, 8*2*100)));
+            reference = grabImage(scene);
+            plot.vertexPulling = true;
+            uploaded = plot.textureBytesUploaded;
+            verify(grabImage(scene).equals(reference));
+            compare(plot.textureBytesUploaded, uploaded);
+            scene.destroy();
+        }
+        function test_vertexPullingLimit() {
+            // point textures hold up to 2^24 points, more points are drawn from vertex buffers
+            var scene = createScene("XYPlot { anchors.fill: parent; lineEnabled: false; markerEnabled: true; markerSize: 1; "
+                                    + "vertexPulling: true; renderStatsEnabled: true; dataSource: DataSource {} }");
+            var plot = scene.children[0];
+            var n = (1 << 24) + 1;
+            verify(plot.dataSource.copyArray1D(new Uint8Array(2*n).buffer, 2*n, QmlPlotting.DataSource.UInt8));
+            grabImage(scene);
+            compare(plot.verticesGenerated, n);
+            verify(plot.dataSource.copyArray1D(new Uint8Array(2*4).buffer, 2*4, QmlPlotting.DataSource.UInt8));
+            grabImage(scene);
+            // six quad corners per marker
+            compare(plot.verticesGenerated, 6*4);
+            scene.destroy();
+        }
+        function test_vertexPullingFill() {
+            // fills of more than 2^23 points have vertex ids beyond the exact float range
+            var scene = createScene("XYPlot { anchors.fill: parent; lineEnabled: false; markerEnabled: false; "
+                                    + "fillEnabled: true; fillColor: \"blue\"; viewRect: Qt.rect(0, 0, 256, 2); "
+                                    + "dataSource: DataSource {} }");
+            var plot = scene.children[0];
+            var n = (1 << 23) + 4096;
+            var xy = new Uint8Array(2*n);
+            for (var i = 0; i < n; ++i) {
+                xy[2*i] = Math.floor(i * 256 / n);
+                xy[2*i+1] = 1;
+            }
+            verify(plot.dataSource.copyArray1D(xy.buffer, 2*n, QmlPlotting.DataSource.UInt8));
+            var reference = grabImage(scene);
+            compare(reference.blue(256, 384), 255);
+            compare(reference.red(256, 384), 0);
+            plot.vertexPulling = true;
+            verify(grabImage(scene).equals(reference));
+            scene.destroy();
+        }
+        function test_sharedPoints() {
+            var plot = "XYPlot { anchors.fill: parent; markerEnabled: false; vertexPulling: true; "
+                    + "viewRect: Qt.rect(-1, 0, 2, 1); renderStatsEnabled: true; dataSource: shared } ";
+            var scene = createScene("DataSource { id: shared } " + plot + plot);
+            var source = scene.children[0];
+            var first = scene.children[1];
+            var second = scene.children[2];
+            compare(first.dataSource, second.dataSource);
+
+            // the point texture of each generation is uploaded once, by the plot rendered first
+            for (var k = 0; k < 2; ++k) {
+                var uploaded = [first.textureBytesUploaded, second.textureBytesUploaded];
+                source.setTestData1D();
+                grabImage(scene);
+                var deltas = [first.textureBytesUploaded - uploaded[0], second.textureBytesUploaded - uploaded[1]].sort(function(a, b) { return a - b; });
+                compare(deltas[0], 0);
+                compare(deltas[1], 4096 * 2 * 4);
+            }
+
+            // partial commits upload the changed points only, 8 elements are 4 points
+            uploaded = [first.textureBytesUploaded, second.textureBytesUploaded];
+            verify(source.commitRegion(16, 0, 8, 1));
+            grabImage(scene);
+            deltas = [first.textureBytesUploaded - uploaded[0], second.textureBytesUploaded - uploaded[1]].sort(function(a, b) { return a - b; });
+            compare(deltas[0], 0);
+            compare(deltas[1], 4 * 2 * 4);
+            scene.destroy();
+        }
+        function test_markerAttributes() {
+            var scene = createScene("XYPlot { anchors.fill: parent; lineEnabled: false; markerSize: 4; vertexPulling: true; "
+                                    + "viewRect: Qt.rect(0, 0, 4, 1); renderStatsEnabled: true; dataSource: DataSource {} }");
+            var plot = scene.children[0];
+            verify(plot.dataSource.copyArray1D(new Float64Array([.5, .5, 1.5, .5, 2.5, .5, 3.5, .5]).buffer, 8, QmlPlotting.DataSource.Float64));
+            var plain = grabImage(scene);
+            // last marker is centered at pixel (448, 256)
+            compare(plain.red(448, 256), 0);
+            compare(plain.red(454, 256), 255);
+
+            // sizes of 16 pixels reach beyond the default markers, one size per point in a row of 4096
+            var sizes = Qt.createQmlObject("import QmlPlotting 2.0; DataSource {}", scene);
+            verify(sizes.copyArray1D(new Float32Array([2, 4, 8, 16]).buffer, 4, QmlPlotting.DataSource.Float32));
+            var uploaded = plot.textureBytesUploaded;
+            plot.markerSizeSource = sizes;
+            var image = grabImage(scene);
+            compare(plot.textureBytesUploaded - uploaded, 4096 * 4);
+            compare(image.red(454, 256), 0);
+
+            // colour values are mapped through the colormap, 16 is the bright end of viridis
+            plot.markerColormap = "viridis";
+            plot.markerColorMax = 16;
+            uploaded = plot.textureBytesUploaded;
+            plot.markerColorSource = sizes;
+            image = grabImage(scene);
+            verify(plot.textureBytesUploaded - uploaded >= 2 * 4096 * 4);
+            verify(image.green(448, 256) > 200);
+
+            // decimated points have no attributes, markers fall back to markerSize and markerColor
+            plot.decimationEnabled = true;
+            verify(grabImage(scene).equals(plain));
+            scene.destroy();
+        }
+        function test_stream() {
+            var source = xyPlot.dataSource;
+            source.allocateStream1D(2*4);
+            verify(source.streaming);
+            verify(source.append(new Float64Array([0, 1, 1, 2, 2, 3]).buffer));
+            compare(source.streamLength, 6);
+            compare(source.streamOffset, 0);
+            verify(source.append(new Float64Array([3, 4, 4, 5]).buffer));
+            compare(source.streamLength, 8);
+            compare(source.streamOffset, 2);
+            source.setTestData1D();
+            verify(!source.streaming);
+        }
+        function test_publishBackBuffer() {
+            var source = xyPlot.dataSource;
+            source.allocateBackBuffer1D(2*16, QmlPlotting.DataSource.Float32);
+            source.publishBackBuffer();
+            tryCompare(source, "dataWidth", 2*16);
+            compare(source.dataType, QmlPlotting.DataSource.Float32);
+            source.dataType = QmlPlotting.DataSource.Float64;
+            source.setTestData1D();
+        }
+        function test_coalesce() {
+            var source = xyPlot.dataSource;
+            wait(0);
+            var generation = source.generation;
+            var coalesced = source.commitsCoalesced;
+            var spy = Qt.createQmlObject("import QtTest 1.0; SignalSpy { signalName: \"commitsCoalescedChanged\" }", xyPlot);
+            spy.target = source;
+            source.setTestData1D();
+            source.setTestData1D();
+            source.setTestData1D();
+            compare(source.generation, generation + 3);
+            compare(source.commitsCoalesced, coalesced + 2);
+            // bindings see every coalesced commit without waiting for dataChanged
+            compare(spy.count, 2);
+            spy.destroy();
+            wait(0);
+            verify(xyPlot.commitsCoalesced >= 2);
+        }
+        function test_renderStats() {
+            var spy = Qt.createQmlObject("import QtTest 1.0; SignalSpy { signalName: \"renderStatsChanged\" }", xyPlot);
+            spy.target = xyPlot;
+            xyPlot.dataSource.setTestData1D();
+            wait(0);
+            compare(spy.count, 0);
+            xyPlot.renderStatsEnabled = true;
+            xyPlot.dataSource.setTestData1D();
+            spy.wait();
+            verify(xyPlot.verticesGenerated > 0);
+            verify(xyPlot.paintNodeTime >= 0);
+            verify(xyPlot.textureBytesUploaded >= 0);
+            verify(xyPlot.dataConversions > 0);
+            xyPlot.renderStatsEnabled = false;
+            spy.destroy();
+        }
+        function test_asyncCommit() {
+            var source = xyPlot.dataSource;
+            var spy = Qt.createQmlObject("import QtTest 1.0; SignalSpy { signalName: \"dataReady\" }", xyPlot);
+            spy.target = source;
+            source.asyncCommit = true;
+            source.framesInFlight = 1;
+            source.setTestData1D();
+            source.setTestData1D();
+            spy.wait();
+            compare(source.dataWidth, 2*512);
+            verify(source.dataMaximum > 0);
+            source.asyncCommit = false;
+            source.framesInFlight = 2;
+            spy.destroy();
+        }
+        function test_asyncCommitContinuous() {
+            // commits follow each other faster than the preparation of 2048x2048 values finishes
+            var scene = createScene("DataSource { id: source; asyncCommit: true; framesInFlight: 1; "
+                                    + "property alias committing: timer.running; "
+                                    + "Timer { id: timer; interval: 1; repeat: true; running: true; onTriggered: source.commitData() } }");
+            var source = scene.children[0];
+            var changed = Qt.createQmlObject("import QtTest 1.0; SignalSpy { signalName: \"dataChanged\" }", scene);
+            changed.target = source;
+            var ready = Qt.createQmlObject("import QtTest 1.0; SignalSpy { signalName: \"dataReady\" }", scene);
+            ready.target = source;
+            source.allocateData2D(2048, 2048);
+            // superseded results are shown, dataReady waits for the latest commit
+            changed.wait();
+            changed.wait();
+            // a last commit after the timer stopped is prepared and announced
+            source.committing = false;
+            source.commitData();
+            ready.wait();
+            compare(source.dataWidth, 2048);
+            scene.destroy();
+        }
     }
 
     TestCase {
@@ -31,6 +294,232 @@ QmlPlotting.PlotGroup {
         function test_setTestData() {
             colormappedImage.dataSource.setTestData2D();
         }
+        function test_dataType() {
+            var source = colormappedImage.dataSource;
+            source.dataType = QmlPlotting.DataSource.Float32;
+            compare(source.dataWidth, 0);
+            source.setTestData2D();
+            compare(source.dataWidth, 512);
+            compare(source.dataHeight, 512);
+            source.dataType = QmlPlotting.DataSource.Float64;
+            source.setTestData2D();
+        }
+        function test_copyArray() {
+            var source = colormappedImage.dataSource;
+            var values = new Uint16Array(4*2);
+            verify(source.copyArray2D(values.buffer, 4, 2, QmlPlotting.DataSource.UInt16));
+            compare(source.dataType, QmlPlotting.DataSource.UInt16);
+            compare(source.dataWidth, 4);
+            verify(!source.copyArray2D(values.buffer, 8, 2, QmlPlotting.DataSource.UInt16));
+            source.dataType = QmlPlotting.DataSource.Float64;
+            source.setTestData2D();
+        }
+        function test_commitRegion() {
+            var source = colormappedImage.dataSource;
+            source.setTestData2D();
+            verify(source.commitRegion(10, 20, 100, 5));
+            verify(source.commitRegion(500, 500, 100, 100));
+            verify(!source.commitRegion(600, 600, 10, 10));
+        }
+        function test_autoRange() {
+            var source = colormappedImage.dataSource;
+            source.setTestData2D();
+            colormappedImage.autoRange = true;
+            compare(colormappedImage.minimumValue, source.dataMinimum);
+            compare(colormappedImage.maximumValue, source.dataMaximum);
+            colormappedImage.autoRangePercentile = 1;
+            verify(colormappedImage.maximumValue <= source.dataMaximum);
+            verify(source.percentile(50) >= source.dataMinimum);
+            colormappedImage.autoRange = false;
+            colormappedImage.autoRangePercentile = 0;
+            colormappedImage.minimumValue = 0;
+            colormappedImage.maximumValue = 1;
+        }
+        function test_streamStatistics() {
+            // appends notify statistics once as many rows as the ring buffer holds were appended
+            var source = Qt.createQmlObject("import QmlPlotting 2.0; DataSource {}", colormappedImage);
+            var spy = Qt.createQmlObject("import QtTest 1.0; SignalSpy { signalName: \"statisticsChanged\" }", source);
+            spy.target = source;
+            source.dataType = QmlPlotting.DataSource.Float32;
+            source.allocateStream2D(4, 4);
+            wait(0);
+            compare(spy.count, 1);
+            verify(source.append(new Float32Array([1, 2, 3, 4, 5, 6, 7, 8]).buffer));
+            wait(0);
+            compare(spy.count, 1);
+            verify(source.dataMaximum >= 8);
+            verify(source.append(new Float32Array([9, 9, 9, 9, 9, 9, 9, 9]).buffer));
+            wait(0);
+            compare(spy.count, 2);
+            compare(source.dataMaximum, 9);
+            source.destroy();
+        }
+        function test_reduction() {
+            var source = colormappedImage.dataSource;
+            source.setTestData2D();
+            source.reduction = QmlPlotting.DataSource.PeakReduction;
+            plotGroup.viewRect = Qt.rect(-4, -4, 8, 8);
+            wait(0);
+            compare(source.reduction, QmlPlotting.DataSource.PeakReduction);
+            source.reduction = QmlPlotting.DataSource.NoReduction;
+            plotGroup.viewRect = Qt.rect(0, 0, 1, 1);
+        }
+        function test_pixelBuffers() {
+            var scene = createScene("ColormappedImage { anchors.fill: parent; extent: Qt.vector4d(0, 1, 0, 1); "
+                                    + "viewRect: Qt.rect(0, 0, 1, 1); minimumValue: 0; maximumValue: 1; "
+                                    + "renderStatsEnabled: true; dataSource: DataSource {} }");
+            var image = scene.children[0];
+            var source = image.dataSource;
+            // two different images, converted from double precision into the mapped buffers
+            var size = 64;
+            var data = [new Float64Array(size*size), new Float64Array(size*size)];
+            for (var i = 0; i < size*size; ++i) {
+                data[0][i] = (i % size) / size;
+                data[1][i] = 1 - Math.floor(i / size) / size;
+            }
+            var reference = [];
+            for (var k = 0; k < 2; ++k) {
+                verify(source.copyArray2D(data[k].buffer, size, size, QmlPlotting.DataSource.Float64));
+                reference.push(grabImage(scene));
+            }
+            verify(!reference[0].equals(reference[1]));
+
+            // more commits than buffers in the ring, every buffer is written again while keeping its storage
+            source.pixelBuffers = 2;
+            compare(source.pixelBuffers, 2);
+            for (k = 0; k < 6; ++k) {
+                var uploaded = image.textureBytesUploaded;
+                verify(source.copyArray2D(data[k % 2].buffer, size, size, QmlPlotting.DataSource.Float64));
+                verify(grabImage(scene).equals(reference[k % 2]));
+                compare(image.textureBytesUploaded - uploaded, size * size * 4);
+            }
+            // single precision needs no conversion and is uploaded from client memory
+            verify(source.copyArray2D(new Float32Array(data[0]).buffer, size, size, QmlPlotting.DataSource.Float32));
+            verify(grabImage(scene).equals(reference[0]));
+            source.pixelBuffers = 0;
+            verify(source.copyArray2D(data[0].buffer, size, size, QmlPlotting.DataSource.Float64));
+            verify(grabImage(scene).equals(reference[0]));
+            scene.destroy();
+        }
+        function test_tiles() {
+            // 512x512 data in 4x4 tiles, textures overlap their neighbours by one pixel
+            var scene = createScene("ColormappedImage { anchors.fill: parent; tileSize: 128; tileMemoryBudget: 4; "
+                                    + "extent: Qt.vector4d(0, 1, 0, 1); viewRect: Qt.rect(0, 0, 1, 1); "
+                                    + "renderStatsEnabled: true; dataSource: DataSource {} }");
+            var image = scene.children[0];
+            var source = image.dataSource;
+            source.setTestData2D();
+            grabImage(scene);
+            // outer tiles are 129 pixels wide, inner ones 130
+            var uploaded = image.textureBytesUploaded;
+            compare(uploaded, 4 * 518 * 518);
+
+            // only tiles covering the changed region are uploaded again
+            verify(source.commitRegion(10, 10, 4, 4));
+            grabImage(scene);
+            compare(image.textureBytesUploaded - uploaded, 4 * 129 * 129);
+            uploaded = image.textureBytesUploaded;
+            verify(source.commitRegion(127, 10, 2, 1));
+            grabImage(scene);
+            compare(image.textureBytesUploaded - uploaded, 4 * (129 * 129 + 130 * 129));
+
+            // hidden tiles are uploaded when they become visible again
+            image.viewRect = Qt.rect(0, 0, .25, .25);
+            uploaded = image.textureBytesUploaded;
+            verify(source.commitRegion(300, 300, 1, 1));
+            grabImage(scene);
+            compare(image.textureBytesUploaded, uploaded);
+            image.viewRect = Qt.rect(0, 0, 1, 1);
+            grabImage(scene);
+            compare(image.textureBytesUploaded - uploaded, 4 * 130 * 130);
+
+            // full commits invalidate all tiles
+            uploaded = image.textureBytesUploaded;
+            verify(source.commitData());
+            grabImage(scene);
+            compare(image.textureBytesUploaded - uploaded, 4 * 518 * 518);
+            scene.destroy();
+        }
+        function test_slice() {
+            var source = colormappedImage.dataSource;
+            source.allocateData3D(16, 8, 4);
+            verify(source.commitData());
+            compare(colormappedImage.numSlices, 4);
+            colormappedImage.slice = 2.5;
+            wait(0);
+            colormappedImage.sliceAxis = 1;
+            compare(colormappedImage.numSlices, 8);
+            wait(0);
+            colormappedImage.sliceAxis = 0;
+            colormappedImage.slice = 0;
+            source.setTestData2D();
+            compare(colormappedImage.numSlices, 0);
+        }
+    }
+
+    TestCase {
+        name: "MultiTracePlot"
+        function test_traces() {
+            // value 0 is drawn in pixel row 307 and value 1 in row 102 of view y in [-1, 1.5]
+            var scene = createScene("MultiTracePlot { anchors.fill: parent; viewRect: Qt.rect(0, -1, 16, 2.5); "
+                                    + "traceColors: [\"red\", \"blue\"]; traceOffsets: [0, 1]; dataSource: DataSource {} }");
+            var plot = scene.children[0];
+            var source = plot.dataSource;
+            verify(source.copyArray2D(new Float32Array(16*2).buffer, 16, 2, QmlPlotting.DataSource.Float32));
+            var image = grabImage(scene);
+            compare(image.red(256, 307), 255);
+            compare(image.green(256, 307), 0);
+            compare(image.blue(256, 102), 255);
+            compare(image.red(256, 102), 0);
+
+            // y values of 1D xy data are a single trace, their x values do not move samples
+            var xy = new Float32Array(2*16);
+            for (var i = 0; i < 16; ++i) {
+                xy[2*i] = i + 4;
+                xy[2*i+1] = 1;
+            }
+            verify(source.copyArray1D(xy.buffer, 2*16, QmlPlotting.DataSource.Float32));
+            image = grabImage(scene);
+            compare(image.green(256, 102), 0);
+            compare(image.green(256, 307), 255);
+
+            // ring buffer points are shown oldest first, four new points with y = 1 follow four old points of 0
+            plot.traceOffsets = [];
+            source.allocateStream1D(16);
+            verify(source.append(new Float32Array(16).buffer));
+            verify(source.append(new Float32Array([5, 1, 6, 1, 7, 1, 8, 1]).buffer));
+            compare(source.streamOffset, 8);
+            image = grabImage(scene);
+            compare(image.green(32, 307), 0);
+            compare(image.green(32, 102), 255);
+            compare(image.green(192, 102), 0);
+            compare(image.green(192, 307), 255);
+
+            // 3D data is not drawn
+            source.allocateData3D(4, 4, 4);
+            verify(source.commitData());
+            image = grabImage(scene);
+            compare(image.green(32, 307), 255);
+            compare(image.green(192, 102), 255);
+            scene.destroy();
+        }
+    }
+
+    QmlPlotting.MappedDataSource {
+        id: mappedDataSource
+        dataType: QmlPlotting.DataSource.UInt8
+    }
+
+    TestCase {
+        name: "MappedDataSource"
+        function test_map() {
+            mappedDataSource.shape = [16];
+            mappedDataSource.fileName = Qt.resolvedUrl("tst_basic.qml").toString().replace(/^file:\/\//, "");
+            verify(mappedDataSource.mapped);
+            compare(mappedDataSource.dataWidth, 16);
+            mappedDataSource.fileOffset = 1 << 30;
+            verify(!mappedDataSource.mapped);
+        }
     }
 
     TestCase {
@@ -39,6 +528,7 @@ QmlPlotting.PlotGroup {
             plotGroup.viewRect = Qt.rect(-1, -1, 2, 2);
             compare(plotGroup.viewRect, xyPlot.viewRect);
             compare(plotGroup.viewRect, colormappedImage.viewRect);
+            compare(plotGroup.viewRect, multiTracePlot.viewRect);
         }
     }
 }
@@ -0,0 +1,475 @@
+#include <QtTest>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "convertkernels.h"
+#include "datastatistics.h"
+#include "decimation.h"
+#include "imagepyramid.h"
+#include "minmaxpyramid.h"
+
+// Reference decimation by a full scan, first, min, max and last point of each column in original order
+static std::vector<double> decimateReference(const std::vector<double>& xy, double xmin, double xrange, int num_columns)
+{
+    const auto num_points = static_cast<int>(xy.size() / 2);
+    std::vector<double> xs(static_cast<size_t>(num_points));
+    for (int i = 0; i < num_points; ++i) {
+        xs[static_cast<size_t>(i)] = xy[static_cast<size_t>(2*i)];
+    }
+    const auto lower = [&](double x) {return static_cast<int>(std::lower_bound(xs.begin(), xs.end(), x) - xs.begin());};
+    const int begin = std::max(lower(xmin) - 1, 0);
+    const int end = std::min(lower(xmin + xrange) + 1, num_points);
+    const double column_width = xrange / num_columns;
+
+    std::vector<double> dst;
+    int i = begin;
+    while (i < end) {
+        const double column_end = xmin + (std::floor((xs[static_cast<size_t>(i)] - xmin) / column_width) + 1.) * column_width;
+        int last = i;
+        while (last + 1 < end && xs[static_cast<size_t>(last + 1)] < column_end) {
+            ++last;
+        }
+        int imin = i;
+        int imax = i;
+        for (int k = i; k <= last; ++k) {
+            if (xy[static_cast<size_t>(2*k+1)] < xy[static_cast<size_t>(2*imin+1)]) {
+                imin = k;
+            }
+            if (xy[static_cast<size_t>(2*k+1)] > xy[static_cast<size_t>(2*imax+1)]) {
+                imax = k;
+            }
+        }
+        int idx[4] = {i, std::min(imin, imax), std::max(imin, imax), last};
+        for (int k = 0; k < 4; ++k) {
+            if (k == 0 || idx[k] != idx[k-1]) {
+                dst.push_back(xy[static_cast<size_t>(2*idx[k])]);
+                dst.push_back(xy[static_cast<size_t>(2*idx[k]+1)]);
+            }
+        }
+        i = last + 1;
+    }
+    return dst;
+}
+
+// Check that the points of decimated are a subsequence of the points of xy
+static bool isSubsequence(const std::vector<double>& decimated, const std::vector<double>& xy)
+{
+    size_t j = 0;
+    for (size_t i = 0; i < decimated.size(); i += 2) {
+        while (j < xy.size() && (xy[j] != decimated[i] || xy[j+1] != decimated[i+1])) {
+            j += 2;
+        }
+        if (j == xy.size()) {
+            return false;
+        }
+        j += 2;
+    }
+    return true;
+}
+
+class TestKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decimation();
+    void decimationUnsorted();
+    void decimationRing();
+    void pyramidQuery();
+    void pyramidUpdate();
+    void imagePyramidUpdate();
+    void convertVariants();
+    void statistics();
+};
+
+void TestKernels::decimation()
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> dist(0., 1.);
+    const int num_points = 20000;
+    std::vector<double> xy(2 * num_points);
+    double x = 0.;
+    for (int i = 0; i < num_points; ++i) {
+        x += dist(rng) * 1e-3;
+        xy[static_cast<size_t>(2*i)] = x;
+        xy[static_cast<size_t>(2*i+1)] = dist(rng) - .5;
+    }
+    MinMaxPyramid pyramid;
+    pyramid.build(xy.data() + 1, 2, num_points);
+    QVERIFY(!pyramid.isEmpty());
+
+    // views inside, overlapping and outside of the data, with more and fewer columns than points
+    const double views[][2] = {{2., 5.}, {-1., 3.}, {9., 4.}, {0., x}, {20., 1.}, {-5., 1.}};
+    for (const auto& view : views) {
+        for (int num_columns : {1, 97, 640, 50000}) {
+            const std::vector<double> expected = decimateReference(xy, view[0], view[1], num_columns);
+            std::vector<double> scanned;
+            decimateMinMax(xy.data(), 0, num_points, view[0], view[1], num_columns, nullptr, scanned);
+            QCOMPARE(scanned, expected);
+            std::vector<double> queried;
+            decimateMinMax(xy.data(), 0, num_points, view[0], view[1], num_columns, &pyramid, queried);
+            QCOMPARE(queried, expected);
+        }
+    }
+
+    // single precision data gives the same columns
+    std::vector<float> xy_float(xy.begin(), xy.end());
+    std::vector<double> xy_rounded(xy_float.begin(), xy_float.end());
+    std::vector<double> decimated;
+    decimateMinMax(xy_float.data(), 0, num_points, 2., 5., 640, nullptr, decimated);
+    QCOMPARE(decimated, decimateReference(xy_rounded, 2., 5., 640));
+}
+
+void TestKernels::decimationUnsorted()
+{
+    // unsorted x values break complete columns, the output must still be a bounded subsequence of the input
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> dist(0., 10.);
+    const int num_points = 5000;
+    std::vector<double> xy(2 * num_points);
+    for (double& v : xy) {
+        v = dist(rng);
+    }
+    MinMaxPyramid pyramid;
+    pyramid.build(xy.data() + 1, 2, num_points);
+    const MinMaxPyramid* pyramids[] = {nullptr, &pyramid};
+    for (const MinMaxPyramid* p : pyramids) {
+        std::vector<double> decimated;
+        decimateMinMax(xy.data(), 0, num_points, 2., 5., 100, p, decimated);
+        QVERIFY(decimated.size() <= xy.size());
+        QVERIFY(isSubsequence(decimated, xy));
+    }
+}
+
+void TestKernels::decimationRing()
+{
+    // oldest points start at 900 and wrap around to 0, points behind the ring are never read
+    const int capacity = 1000;
+    const int start = 900;
+    const int length = 500;
+    std::vector<double> ring(2 * capacity, 1e9);
+    std::vector<double> unrolled(2 * length);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> dist(-1., 1.);
+    for (int k = 0; k < length; ++k) {
+        const auto i = static_cast<size_t>((start + k) % capacity);
+        ring[2*i] = unrolled[static_cast<size_t>(2*k)] = k + .5;
+        ring[2*i+1] = unrolled[static_cast<size_t>(2*k+1)] = dist(rng);
+    }
+    MinMaxPyramid pyramid;
+    pyramid.build(ring.data() + 1, 2, capacity);
+
+    // the wrap at 100 points is a column border, both parts together equal the unrolled data
+    const MinMaxPyramid* pyramids[] = {nullptr, &pyramid};
+    for (const MinMaxPyramid* p : pyramids) {
+        std::vector<double> decimated;
+        decimateMinMaxRing(ring.data(), capacity, start, length, 0., 500., 50, p, decimated);
+        QCOMPARE(decimated, decimateReference(unrolled, 0., 500., 50));
+    }
+
+    // a ring which did not wrap yet is a single part
+    std::vector<double> decimated;
+    decimateMinMaxRing(ring.data(), capacity, 0, 400, 0., 1000., 10, nullptr, decimated);
+    std::vector<double> first_part(ring.begin(), ring.begin() + 2 * 400);
+    QCOMPARE(decimated, decimateReference(first_part, 0., 1000., 10));
+}
+
+// Compare pyramid queries of random ranges and of ranges around block borders with a full scan
+static bool checkPyramid(const MinMaxPyramid& pyramid, const std::vector<int32_t>& values, std::mt19937& rng)
+{
+    const auto size = static_cast<int>(values.size());
+    std::uniform_int_distribution<int> position(0, size);
+    std::uniform_int_distribution<int> jitter(-2, 2);
+    std::vector<std::pair<int, int>> ranges;
+    for (int k = 0; k < 500; ++k) {
+        const int a = position(rng);
+        const int b = position(rng);
+        ranges.emplace_back(std::min(a, b), std::max(a, b));
+    }
+    for (int border = 0; border <= size; border += MinMaxPyramid::BlockSize) {
+        const int a = std::max(border + jitter(rng), 0);
+        for (int length : {1, MinMaxPyramid::BlockSize - 1, MinMaxPyramid::BlockSize, 3 * MinMaxPyramid::BlockSize + 1, size}) {
+            ranges.emplace_back(a, std::min(a + length, size));
+        }
+    }
+    for (const auto& range : ranges) {
+        if (range.first >= range.second) {
+            continue;
+        }
+        const auto first = values.begin() + range.first;
+        const auto last = values.begin() + range.second;
+        int index_min;
+        int index_max;
+        pyramid.query(values.data(), 1, range.first, range.second, index_min, index_max);
+        if (index_min < range.first || index_min >= range.second || index_max < range.first || index_max >= range.second) {
+            return false;
+        }
+        // values have duplicates, compare values instead of indices
+        if (values[static_cast<size_t>(index_min)] != *std::min_element(first, last)
+                || values[static_cast<size_t>(index_max)] != *std::max_element(first, last)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestKernels::pyramidQuery()
+{
+    std::mt19937 rng(4);
+    std::uniform_int_distribution<int32_t> dist(-1000, 1000);
+    // sizes below two blocks have no pyramid, others end with partial blocks and odd block counts
+    for (int size : {1, 100, 128, 1000, 4096, 12345}) {
+        std::vector<int32_t> values(static_cast<size_t>(size));
+        for (auto& v : values) {
+            v = dist(rng);
+        }
+        MinMaxPyramid pyramid;
+        pyramid.build(values.data(), 1, size);
+        QCOMPARE(pyramid.isEmpty(), size < 2 * MinMaxPyramid::BlockSize);
+        QVERIFY(checkPyramid(pyramid, values, rng));
+    }
+}
+
+void TestKernels::pyramidUpdate()
+{
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int32_t> dist(-1000, 1000);
+    const int size = 5000;
+    std::vector<int32_t> values(size);
+    for (auto& v : values) {
+        v = dist(rng);
+    }
+    MinMaxPyramid pyramid;
+    pyramid.build(values.data(), 1, size);
+
+    // change ranges inside a block, across block borders and in the partial last block, with new extremes
+    std::uniform_int_distribution<int> position(0, size - 1);
+    for (int k = 0; k < 50; ++k) {
+        const int begin = position(rng);
+        const int end = std::min(begin + 1 + position(rng) % 200, size);
+        for (int i = begin; i < end; ++i) {
+            values[static_cast<size_t>(i)] = dist(rng) * (k % 3 == 0 ? 2 : 1);
+        }
+        pyramid.update(values.data(), 1, begin, end);
+        QVERIFY(checkPyramid(pyramid, values, rng));
+    }
+}
+
+// Random values with special cases, including values which round differently or overflow in single precision
+void TestKernels::imagePyramidUpdate()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    // odd sizes fold the last row/column into the last block, single rows and columns are kept
+    const int sizes[][2] = {{64, 48}, {37, 23}, {5, 3}, {40, 1}, {1, 9}};
+
+    // a single peak in the last row and column survives in every level
+    for (const auto& size : sizes) {
+        const int width = size[0];
+        const int height = size[1];
+        for (auto mode : {ImageReduction::Max, ImageReduction::Min, ImageReduction::Peak}) {
+            const float peak = (mode == ImageReduction::Min) ? -1.f : 1.f;
+            std::vector<float> image(static_cast<size_t>(width) * height);
+            image.back() = peak;
+            std::vector<float> levels;
+            const int num_levels = buildImagePyramid(image.data(), width, height, mode, levels);
+            size_t offset = 0;
+            int level_width = width;
+            int level_height = height;
+            for (int level = 0; level < num_levels; ++level) {
+                level_width = std::max(level_width / 2, 1);
+                level_height = std::max(level_height / 2, 1);
+                offset += static_cast<size_t>(level_width) * level_height;
+                QCOMPARE(levels[offset - 1], peak);
+            }
+            QCOMPARE(offset, levels.size());
+
+            // updating only the last pixel reaches the last block of every level
+            image.back() = 0.f;
+            ImageRegion region;
+            region.x = width - 1;
+            region.y = height - 1;
+            region.width = 1;
+            region.height = 1;
+            std::vector<ImageRegion> changed;
+            updateImagePyramid(image.data(), width, height, mode, region, levels.data(), changed);
+            QVERIFY(std::all_of(levels.begin(), levels.end(), [](float v) {return v == 0.f;}));
+        }
+    }
+
+    for (const auto& size : sizes) {
+        const int width = size[0];
+        const int height = size[1];
+        for (auto mode : {ImageReduction::Mean, ImageReduction::Max, ImageReduction::Peak}) {
+            std::vector<float> image(static_cast<size_t>(width) * height);
+            for (auto& v : image) {
+                v = dist(rng);
+            }
+            std::vector<float> levels;
+            const int num_levels = buildImagePyramid(image.data(), width, height, mode, levels);
+
+            // updated levels match rebuilt ones, only pixels in the changed rectangles differ
+            std::uniform_int_distribution<int> position(0, std::max(width, height) - 1);
+            for (int k = 0; k < 20; ++k) {
+                ImageRegion region;
+                region.x = position(rng) % width;
+                region.y = position(rng) % height;
+                region.width = std::min(1 + position(rng) % 8, width - region.x);
+                region.height = std::min(1 + position(rng) % 8, height - region.y);
+                for (int y = region.y; y < region.y + region.height; ++y) {
+                    for (int x = region.x; x < region.x + region.width; ++x) {
+                        image[static_cast<size_t>(y) * width + x] = dist(rng);
+                    }
+                }
+                const std::vector<float> previous = levels;
+                std::vector<ImageRegion> changed;
+                QCOMPARE(updateImagePyramid(image.data(), width, height, mode, region, levels.data(), changed), num_levels);
+                QCOMPARE(static_cast<int>(changed.size()), num_levels);
+                std::vector<float> rebuilt;
+                buildImagePyramid(image.data(), width, height, mode, rebuilt);
+                QVERIFY(levels == rebuilt);
+
+                size_t offset = 0;
+                int level_width = width;
+                int level_height = height;
+                for (const ImageRegion& rect : changed) {
+                    level_width = std::max(level_width / 2, 1);
+                    level_height = std::max(level_height / 2, 1);
+                    for (int y = 0; y < level_height; ++y) {
+                        for (int x = 0; x < level_width; ++x) {
+                            const size_t i = offset + static_cast<size_t>(y) * level_width + x;
+                            const bool inside = x >= rect.x && x < rect.x + rect.width && y >= rect.y && y < rect.y + rect.height;
+                            QVERIFY(inside || levels[i] == previous[i]);
+                        }
+                    }
+                    offset += static_cast<size_t>(level_width) * level_height;
+                }
+            }
+        }
+    }
+}
+
+static std::vector<double> convertInput(int size)
+{
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    const double special[] = {0., -0., 1. + 1e-9, 1e-310, -1e39, 3.5e38, std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+    std::vector<double> values(static_cast<size_t>(size));
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = (i % 7 == 3) ? special[i % (sizeof(special) / sizeof(special[0]))] : dist(rng);
+    }
+    return values;
+}
+
+void TestKernels::convertVariants()
+{
+    QVERIFY(convertKernelsNumVariants() >= 1);
+    QCOMPARE(std::strcmp(convertKernelsVariantName(0), "scalar"), 0);
+    QCOMPARE(std::strcmp(convertKernelsVariantName(convertKernelsNumVariants() - 1), convertKernelsInstructionSet()), 0);
+
+    // odd lengths leave scalar tails, offsets misalign source and destination
+    const std::vector<double> input = convertInput(2 * 1031 + 8);
+    for (int variant = 0; variant < convertKernelsNumVariants(); ++variant) {
+        for (int size : {0, 1, 3, 7, 8, 9, 17, 1031}) {
+            for (int offset : {0, 1, 3}) {
+                const double* src = input.data() + offset;
+                std::vector<float> expected(4 * static_cast<size_t>(size));
+                std::vector<float> converted(static_cast<size_t>(size) + 8, -1.f);
+                for (int i = 0; i < size; ++i) {
+                    expected[static_cast<size_t>(i)] = static_cast<float>(src[i]);
+                }
+                convertToFloatVariant(variant, src, size, converted.data() + offset);
+                QCOMPARE(std::memcmp(converted.data() + offset, expected.data(), sizeof(float) * static_cast<size_t>(size)), 0);
+                // elements behind the range are not written
+                QCOMPARE(converted[static_cast<size_t>(offset + size)], -1.f);
+
+                for (int i = 0; i < size; ++i) {
+                    expected[static_cast<size_t>(4*i+0)] = static_cast<float>(src[2*i+0]);
+                    expected[static_cast<size_t>(4*i+1)] = 0.f;
+                    expected[static_cast<size_t>(4*i+2)] = static_cast<float>(src[2*i+0]);
+                    expected[static_cast<size_t>(4*i+3)] = static_cast<float>(src[2*i+1]);
+                }
+                std::vector<float> filled(4 * static_cast<size_t>(size) + 8, -1.f);
+                convertFillPointsVariant(variant, src, size, filled.data() + offset);
+                QCOMPARE(std::memcmp(filled.data() + offset, expected.data(), 4 * sizeof(float) * static_cast<size_t>(size)), 0);
+                QCOMPARE(filled[static_cast<size_t>(offset + 4*size)], -1.f);
+            }
+        }
+    }
+
+    // dispatched and threaded conversion of large arrays
+    const int size = 3 * (1 << 16) + 5;
+    const std::vector<double> large = convertInput(size);
+    std::vector<float> expected(static_cast<size_t>(size));
+    std::vector<float> converted(static_cast<size_t>(size));
+    convertToFloatVariant(0, large.data(), size, expected.data());
+    convertToFloat(large.data(), size, converted.data());
+    QCOMPARE(std::memcmp(converted.data(), expected.data(), sizeof(float) * expected.size()), 0);
+}
+
+void TestKernels::statistics()
+{
+    // several chunks with non-finite values spread over all lanes
+    std::mt19937 rng(9);
+    std::normal_distribution<double> dist(3., 2.);
+    const int size = 3 * DataStatistics::ChunkSize + 123;
+    std::vector<double> values(static_cast<size_t>(size));
+    for (int i = 0; i < size; ++i) {
+        const int k = i % 97;
+        values[static_cast<size_t>(i)] = (k == 5) ? std::numeric_limits<double>::quiet_NaN()
+                                       : (k == 11) ? std::numeric_limits<double>::infinity()
+                                       : (k == 13) ? -std::numeric_limits<double>::infinity() : dist(rng);
+    }
+    std::vector<double> sorted;
+    for (double v : values) {
+        if (std::isfinite(v)) {
+            sorted.push_back(v);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end());
+    const auto n = static_cast<int64_t>(sorted.size());
+
+    DataStatistics statistics;
+    statistics.build(values.data(), size);
+    QCOMPARE(statistics.count(), n);
+    QCOMPARE(statistics.minimum(), sorted.front());
+    QCOMPARE(statistics.maximum(), sorted.back());
+    double sum = 0.;
+    for (double v : sorted) {
+        sum += v;
+    }
+    QVERIFY(std::abs(statistics.mean() - sum / n) < 1e-9);
+
+    // percentiles are accurate to one histogram bin
+    const double bin_width = (sorted.back() - sorted.front()) / DataStatistics::NumBins;
+    for (double percent : {0., .1, 1., 5., 25., 50., 75., 95., 99., 99.9, 100.}) {
+        const auto rank = static_cast<int64_t>(std::ceil(percent * .01 * n)) - 1;
+        const double reference = sorted[static_cast<size_t>(std::min(std::max<int64_t>(rank, 0), n - 1))];
+        QVERIFY(std::abs(statistics.percentile(percent) - reference) <= bin_width * 1.001);
+    }
+
+    // strided values, the interleaved x values are ignored
+    std::vector<float> xy(2 * sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        xy[2*i] = 1e6f;
+        xy[2*i+1] = static_cast<float>(sorted[i]);
+    }
+    statistics.build(xy.data() + 1, n, 2);
+    QCOMPARE(statistics.count(), n);
+    QCOMPARE(statistics.minimum(), static_cast<double>(static_cast<float>(sorted.front())));
+    QCOMPARE(statistics.maximum(), static_cast<double>(static_cast<float>(sorted.back())));
+
+    // only non-finite values
+    const float empty[] = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()};
+    statistics.build(empty, 2);
+    QVERIFY(statistics.isEmpty());
+    QCOMPARE(statistics.percentile(50.), 0.);
+}
+
+QTEST_APPLESS_MAIN(TestKernels)
+
+#include "tst_kernels.moc"
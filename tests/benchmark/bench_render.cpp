@@ -0,0 +1,334 @@
+// Offscreen render benchmark of the plot items.
+//
+// Every scene is rendered through QQuickRenderControl into a framebuffer object for data sizes from 1e3 to 1e8
+// values. Reported per scene and size are the commit time (copy into the data source and commitData), the sync
+// time of the first frame (all updatePaintNode calls including texture uploads), the render time of the first
+// frame, the mean frame time while panning and the number of uploaded texture bytes.
+//
+// Runs headless on Mesa llvmpipe, e.g.:
+//   QT_QPA_PLATFORM=offscreen LIBGL_ALWAYS_SOFTWARE=1 bench_render --format json --output results.json
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickRenderControl>
+#include <QQuickWindow>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+struct Scene {
+    const char* name;
+    const char* qml;
+};
+
+// Data sources are filled by object name, source1D with xy pairs and source2D with a square image
+static const Scene scenes[] = {
+    {"XYPlot",
+     "import QmlPlotting 2.0\n"
+     "XYPlot { lineEnabled: true; viewRect: Qt.rect(0, -1, 1, 2); dataSource: DataSource { objectName: \"source1D\" } }"},
+    {"ColormappedImage",
+     "import QmlPlotting 2.0\n"
+     "ColormappedImage { objectName: \"image\"; viewRect: Qt.rect(0, 0, 1, 1); extent: Qt.vector4d(0, 1, 0, 1);"
+     " dataSource: DataSource { objectName: \"source2D\" } }"},
+    {"SlicePlot",
+     "import QmlPlotting 2.0\n"
+     "SlicePlot { numSegments: 1024; p1: Qt.point(0, 0.5); p2: Qt.point(1, 0.5);"
+     " dataSource: DataSource { objectName: \"source2D\" } }"},
+    {"PlotGroup",
+     "import QmlPlotting 2.0\n"
+     "PlotGroup { viewRect: Qt.rect(0, -1, 1, 2); plotItems: ["
+     " ColormappedImage { objectName: \"image\"; extent: Qt.vector4d(0, 1, -1, 1); dataSource: DataSource { objectName: \"source2D\" } },"
+     " XYPlot { dataSource: DataSource { objectName: \"source1D\" } } ] }"},
+};
+
+struct Result {
+    QString scene;
+    qint64 size;
+    double commit_ms;
+    double sync_ms;
+    double render_ms;
+    double frame_ms;
+    qint64 upload_bytes;
+};
+
+static double milliseconds(qint64 nsecs)
+{
+    return nsecs * 1e-6;
+}
+
+class OffscreenRenderer
+{
+public:
+    explicit OffscreenRenderer(const QSize& size) : m_size(size) {}
+
+    ~OffscreenRenderer() {
+        if (m_context.isValid()) {
+            m_context.makeCurrent(&m_surface);
+            m_fbo.reset();
+            m_window.reset();
+            m_control.reset();
+            m_context.doneCurrent();
+        }
+    }
+
+    bool initialize() {
+        if (!m_context.create()) {
+            return false;
+        }
+        m_surface.setFormat(m_context.format());
+        m_surface.create();
+        m_control.reset(new QQuickRenderControl);
+        m_window.reset(new QQuickWindow(m_control.get()));
+        m_window->setGeometry(0, 0, m_size.width(), m_size.height());
+        m_window->contentItem()->setSize(m_size);
+        if (!m_context.makeCurrent(&m_surface)) {
+            return false;
+        }
+        m_control->initialize(&m_context);
+        m_fbo.reset(new QOpenGLFramebufferObject(m_size, QOpenGLFramebufferObject::CombinedDepthStencil));
+        m_window->setRenderTarget(m_fbo.get());
+        m_context.functions()->glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_max_texture_size);
+        return true;
+    }
+
+    QQuickWindow* window() const {return m_window.get();}
+    int maxTextureSize() const {return m_max_texture_size;}
+
+    // Render a single frame, times in nanoseconds, rendering includes waiting for the GPU
+    void renderFrame(qint64& sync_time, qint64& render_time) {
+        QCoreApplication::processEvents();
+        QElapsedTimer timer;
+        timer.start();
+        m_control->polishItems();
+        m_control->sync();
+        sync_time = timer.nsecsElapsed();
+        m_control->render();
+        m_context.functions()->glFinish();
+        render_time = timer.nsecsElapsed() - sync_time;
+    }
+
+private:
+    QSize m_size;
+    QOpenGLContext m_context;
+    QOffscreenSurface m_surface;
+    std::unique_ptr<QQuickRenderControl> m_control;
+    std::unique_ptr<QQuickWindow> m_window;
+    std::unique_ptr<QOpenGLFramebufferObject> m_fbo;
+    int m_max_texture_size = 0;
+};
+
+// Copy data into a data source and commit it, returns the commit time in nanoseconds
+static qint64 commitSource(QObject* source, const std::vector<double>& values, int width, int height)
+{
+    QElapsedTimer timer;
+    timer.start();
+    void* data = nullptr;
+    if (height > 0) {
+        QMetaObject::invokeMethod(source, "allocateData2D", Q_RETURN_ARG(void*, data), Q_ARG(int, width), Q_ARG(int, height));
+    } else {
+        QMetaObject::invokeMethod(source, "allocateData1D", Q_RETURN_ARG(void*, data), Q_ARG(int, width));
+    }
+    if (data != nullptr) {
+        std::memcpy(data, values.data(), values.size() * sizeof(double));
+    }
+    bool committed = false;
+    QMetaObject::invokeMethod(source, "commitData", Q_RETURN_ARG(bool, committed));
+    return timer.nsecsElapsed();
+}
+
+static bool runScene(OffscreenRenderer& renderer, QQmlEngine& engine, const Scene& scene, qint64 size,
+                     int num_frames, Result& result)
+{
+    const int max_texture_size = renderer.maxTextureSize();
+    const qint64 num_points = size / 2;
+    const int side = static_cast<int>(std::lround(std::sqrt(static_cast<double>(size))));
+
+    QQmlComponent component(&engine);
+    component.setData(scene.qml, QUrl());
+    std::unique_ptr<QQuickItem> root(qobject_cast<QQuickItem*>(component.create()));
+    if (!root) {
+        qWarning("%s: %s", scene.name, qPrintable(component.errorString()));
+        return false;
+    }
+    const QList<QObject*> sources1D = root->findChildren<QObject*>(QStringLiteral("source1D"));
+    const QList<QObject*> sources2D = root->findChildren<QObject*>(QStringLiteral("source2D"));
+    if (!sources1D.isEmpty() && 2 * num_points > max_texture_size) {
+        qWarning("%s: skipping size %lld, 1D data exceeds maximum texture size %d", scene.name, size, max_texture_size);
+        return false;
+    }
+    if (side > max_texture_size) {
+        // larger images are only supported in tiled mode
+        for (QObject* image : root->findChildren<QObject*>(QStringLiteral("image"))) {
+            image->setProperty("tileSize", std::min(max_texture_size, 4096));
+        }
+        if (root->objectName() == QLatin1String("image")) {
+            root->setProperty("tileSize", std::min(max_texture_size, 4096));
+        }
+    }
+    root->setParentItem(renderer.window()->contentItem());
+    root->setSize(renderer.window()->contentItem()->size());
+
+    result.scene = QString::fromLatin1(scene.name);
+    result.size = size;
+    result.commit_ms = 0.;
+    result.upload_bytes = 0;
+
+    // data is committed as double precision and uploaded as float textures
+    if (!sources1D.isEmpty()) {
+        std::vector<double> values(static_cast<size_t>(2 * num_points));
+        for (qint64 i = 0; i < num_points; ++i) {
+            const double x = static_cast<double>(i) / num_points;
+            values[2*i+0] = x;
+            values[2*i+1] = std::sin(x * 200.);
+        }
+        for (QObject* source : sources1D) {
+            result.commit_ms += milliseconds(commitSource(source, values, static_cast<int>(values.size()), 0));
+            result.upload_bytes += static_cast<qint64>(values.size() * sizeof(float));
+        }
+    }
+    if (!sources2D.isEmpty()) {
+        std::vector<double> values(static_cast<size_t>(side) * side);
+        for (int iy = 0; iy < side; ++iy) {
+            for (int ix = 0; ix < side; ++ix) {
+                const double x = -1. + 2. * ix / side;
+                const double y = -1. + 2. * iy / side;
+                values[static_cast<size_t>(iy) * side + ix] = std::exp(-(x*x + y*y) * 2.);
+            }
+        }
+        for (QObject* source : sources2D) {
+            result.commit_ms += milliseconds(commitSource(source, values, side, side));
+            result.upload_bytes += static_cast<qint64>(values.size() * sizeof(float));
+        }
+    }
+
+    // first frame after the commit includes texture uploads and geometry generation
+    qint64 sync_time = 0;
+    qint64 render_time = 0;
+    renderer.renderFrame(sync_time, render_time);
+    result.sync_ms = milliseconds(sync_time);
+    result.render_ms = milliseconds(render_time);
+
+    // steady frames, pan the view to force updatePaintNode without new data
+    const bool has_view = root->metaObject()->indexOfProperty("viewRect") >= 0;
+    const QRectF view = root->property("viewRect").toRectF();
+    qint64 total_time = 0;
+    for (int frame = 0; frame < num_frames; ++frame) {
+        if (has_view) {
+            root->setProperty("viewRect", view.translated(view.width() * 0.01 * (frame % 10), 0.));
+        } else {
+            root->update();
+        }
+        renderer.renderFrame(sync_time, render_time);
+        total_time += sync_time + render_time;
+    }
+    result.frame_ms = (num_frames > 0) ? milliseconds(total_time) / num_frames : 0.;
+
+    root->setParentItem(nullptr);
+    root.reset();
+    // release textures of the deleted items
+    renderer.renderFrame(sync_time, render_time);
+    return true;
+}
+
+static void writeCsv(QTextStream& out, const std::vector<Result>& results)
+{
+    out << "scene,size,commit_ms,sync_ms,render_ms,frame_ms,upload_bytes\n";
+    for (const Result& r : results) {
+        out << r.scene << ',' << r.size << ',' << r.commit_ms << ',' << r.sync_ms << ','
+            << r.render_ms << ',' << r.frame_ms << ',' << r.upload_bytes << '\n';
+    }
+}
+
+static void writeJson(QTextStream& out, const std::vector<Result>& results)
+{
+    QJsonArray array;
+    for (const Result& r : results) {
+        QJsonObject object;
+        object[QStringLiteral("scene")] = r.scene;
+        object[QStringLiteral("size")] = static_cast<double>(r.size);
+        object[QStringLiteral("commit_ms")] = r.commit_ms;
+        object[QStringLiteral("sync_ms")] = r.sync_ms;
+        object[QStringLiteral("render_ms")] = r.render_ms;
+        object[QStringLiteral("frame_ms")] = r.frame_ms;
+        object[QStringLiteral("upload_bytes")] = static_cast<double>(r.upload_bytes);
+        array.append(object);
+    }
+    out << QJsonDocument(array).toJson();
+}
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Offscreen render benchmark of the QmlPlotting items"));
+    parser.addHelpOption();
+    QCommandLineOption format_option(QStringLiteral("format"), QStringLiteral("Output format, csv or json."), QStringLiteral("format"), QStringLiteral("csv"));
+    QCommandLineOption output_option(QStringLiteral("output"), QStringLiteral("Output file, standard output if not set."), QStringLiteral("file"));
+    QCommandLineOption min_option(QStringLiteral("min-size"), QStringLiteral("Smallest number of data values."), QStringLiteral("size"), QStringLiteral("1000"));
+    QCommandLineOption max_option(QStringLiteral("max-size"), QStringLiteral("Largest number of data values."), QStringLiteral("size"), QStringLiteral("100000000"));
+    QCommandLineOption frames_option(QStringLiteral("frames"), QStringLiteral("Number of steady frames per run."), QStringLiteral("frames"), QStringLiteral("20"));
+    QCommandLineOption scene_option(QStringLiteral("scene"), QStringLiteral("Run only the given scene, may be repeated."), QStringLiteral("name"));
+    parser.addOptions({format_option, output_option, min_option, max_option, frames_option, scene_option});
+    parser.process(app);
+
+    const qint64 min_size = std::max(parser.value(min_option).toLongLong(), 1LL);
+    const qint64 max_size = parser.value(max_option).toLongLong();
+    const int num_frames = parser.value(frames_option).toInt();
+    const QStringList selected = parser.values(scene_option);
+
+    OffscreenRenderer renderer(QSize(1024, 768));
+    if (!renderer.initialize()) {
+        qCritical("Failed to create offscreen OpenGL context");
+        return 1;
+    }
+    QQmlEngine engine;
+    engine.addImportPath(QStringLiteral(QMLPLOTTING_IMPORT_DIR));
+
+    // sweep sizes in decades
+    std::vector<Result> results;
+    for (const Scene& scene : scenes) {
+        if (!selected.isEmpty() && !selected.contains(QLatin1String(scene.name))) {
+            continue;
+        }
+        for (qint64 size = min_size; size <= max_size; size *= 10) {
+            Result result;
+            if (runScene(renderer, engine, scene, size, num_frames, result)) {
+                results.push_back(result);
+            }
+        }
+    }
+
+    QFile file;
+    if (parser.isSet(output_option)) {
+        file.setFileName(parser.value(output_option));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qCritical("Failed to open %s", qPrintable(file.fileName()));
+            return 1;
+        }
+    } else {
+        file.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+    QTextStream out(&file);
+    if (parser.value(format_option) == QLatin1String("json")) {
+        writeJson(out, results);
+    } else {
+        writeCsv(out, results);
+    }
+    return 0;
+}